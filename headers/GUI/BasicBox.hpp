@@ -50,11 +50,14 @@
 #include <QGraphicsSvgItem>
 #include <map>
 #include <QMap>
+#include <QSet>
 #include <vector>
 #include <string>
 #include <QInputDialog>
 #include "AbstractBox.hpp"
 #include "CSPTypes.hpp"
+#include "BoxExtremity.hpp"
+#include "AddressTable.hpp"
 #include "CurvesWidget.hpp"
 #include "BoxWidget.hpp"
 #include <QComboBox>
@@ -74,12 +77,6 @@ class Relation;
 class AbstractCurve;
 class QObject;
 
-/*!
- * \brief Enum used to manage various box extremities.
- */
-enum BoxExtremity { NO_EXTREMITY = -1, BOX_START = BEGIN_CONTROL_POINT_INDEX,
-                    BOX_END = END_CONTROL_POINT_INDEX };
-
 /*!
  * \class BasicBox
  *
@@ -254,6 +251,14 @@ class BasicBox : public QObject, public QGraphicsItem
      */
     bool playing() const;
 
+    /*!
+     * \brief Moves the progress band to the current progression of the box,
+     * only invalidating the strip between its previous and new positions.
+     *
+     * \return the invalidated area in scene coordinates, empty if the band did not move
+     */
+    QRectF updateProgress();
+
     /*!
      * \brief Informs the box that a specific extremity is crossed while playing.
      *
@@ -322,11 +327,12 @@ class BasicBox : public QObject, public QGraphicsItem
      */
     std::string triggerPointMessage(BoxExtremity extremity);
 
-    AbstractCurve *getCurve(const std::string &address);
-    void setCurve(const std::string &address, AbstractCurve *curve);
-    void removeCurve(const std::string &address);
-    void addCurve(const std::string &address);
-    void addCurveAddress(const std::string &address);
+    AbstractCurve *getCurve(AddressID address);
+    void setCurve(AddressID address, AbstractCurve *curve);
+    void removeCurve(AddressID address);
+    void addCurve(AddressID address);
+    void addCurveAddress(AddressID address);
+    void removeCurveAddress(AddressID address);
     void curveShowChanged(const QString &address, bool state);
     QRectF boxRect();
     QRectF boxBody();
@@ -545,14 +551,14 @@ class BasicBox : public QObject, public QGraphicsItem
      *
      * \return the message to send at box's start
      */
-    std::vector<std::string> firstMessagesToSend() const;
+    const std::vector<std::string> &firstMessagesToSend() const;
 
     /*!
      * \brief Gets message to send when the end of the box is reached.
      *
      * \return the message to send at box's end
      */
-    std::vector<std::string> lastMessagesToSend() const;
+    const std::vector<std::string> &lastMessagesToSend() const;
 
     /*!
      * \brief Sets messages to send when the start of the box is reached.
@@ -671,8 +677,7 @@ class BasicBox : public QObject, public QGraphicsItem
     leftEar(){ return _leftEar; }
     inline QRectF
     rightEar(){ return _rightEar; }
-    inline BoxWidget *
-    boxContentWidget(){ return _boxContentWidget; }
+    BoxWidget *boxContentWidget();
     inline QWidget *
     boxWidget(){ return _boxWidget; }
     inline MaquetteScene *
@@ -682,7 +687,7 @@ class BasicBox : public QObject, public QGraphicsItem
     inline void
     setStackedLayout(QStackedLayout *slayout){ boxContentWidget()->setStackedLayout(slayout); }
     inline bool
-    hasCurve(string address){ return _curvesAddresses.contains(address); }
+    hasCurve(AddressID address){ return _curvesAddresses.contains(address); }
 
     QPointF getLeftGripPoint();
     QPointF getRightGripPoint();
@@ -709,7 +714,32 @@ class BasicBox : public QObject, public QGraphicsItem
     QMap<QString, QPair<QString, unsigned int> > getFinalState();
     QMap<QString, QPair<QString, unsigned int> > getStartState();
 
+    /*!
+     * \brief Tells if the widgets of the box (curves, messages menus, combo box) exist.
+     *
+     * \return true if the contents are built
+     */
+    inline bool
+    hasContents() const { return _boxContentWidget != NULL; }
+
+    /*!
+     * \brief Builds the widgets of the box if they do not exist,
+     * and fills the curves from the Engines.
+     */
+    void materializeContents();
+
+    /*!
+     * \brief Deletes the widgets of the box, keeping its data.
+     * They are built again by materializeContents().
+     */
+    void releaseContents();
+
   protected:
+    /*!
+     * \brief Creates the widgets of the box, without filling the curves.
+     */
+    virtual void createContents();
+
     /*!
      * \brief Create the QInputDialog, for asking new name.
      */
@@ -799,11 +829,12 @@ class BasicBox : public QObject, public QGraphicsItem
     QMenu* _contextMenu;                                                        //!< The contextual menu, if one.
     bool _shift;                                                                //!< State of Shift Key.
     bool _playing;                                                              //!< State of playing.
+    float _progressPosX;                                                        //!< Position of the progress band drawn.
     TextEdit *_trgPntMsgEdit;                                                   //!< The trigger point editing dialog.
     Comment *_comment;                                                          //!< The box comment.
     QMap<BoxExtremity, TriggerPoint*> *_triggerPoints;                          //!< The trigger points.
     std::map < BoxExtremity, std::map < unsigned int, Relation* > > _relations; //!< The relations.
-    std::map<std::string, AbstractCurve*> _abstractCurves;                      //!< The Curves
+    std::map<AddressID, AbstractCurve*> _abstractCurves;                        //!< The Curves
     BoxWidget *_boxContentWidget;
 
     QRectF _boxRect;
@@ -818,7 +849,7 @@ class BasicBox : public QObject, public QGraphicsItem
     QComboBox *_comboBox;
     QGraphicsProxyWidget *_curveProxy;
     QGraphicsProxyWidget *_comboBoxProxy;
-    QList<string> _curvesAddresses;
+    QSet<AddressID> _curvesAddresses;
     bool _flexible;
     qreal _currentZvalue;
     QColor _color;
@@ -836,5 +867,7 @@ class BasicBox : public QObject, public QGraphicsItem
 
     QPushButton *_startMenuButton;
     QPushButton *_endMenuButton;
+    QGraphicsProxyWidget *_startMenuProxy;
+    QGraphicsProxyWidget *_endMenuProxy;
 };
 #endif
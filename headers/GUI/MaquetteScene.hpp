@@ -59,10 +59,14 @@
 #include "TimeBarWidget.hpp"
 #include "MaquetteView.hpp"
 #include <QTimeLine>
+#include <QElapsedTimer>
+#include <QBasicTimer>
 
 #include <map>
 #include <vector>
 #include <string>
+#include <list>
+#include <set>
 
 class MaquetteView;
 class BasicBox;
@@ -73,7 +77,7 @@ class MaquetteContextMenu;
 class Relation;
 class Comment;
 class TriggerPoint;
-class PlayingThread;
+class PlaybackClock;
 class TimeBarWidget;
 class NetworkTree;
 
@@ -101,6 +105,15 @@ typedef enum { NB_MODE = -1, CB_MODE = 0, SB_MODE = 1, PB_MODE = 2 } BoxCreation
 typedef enum { NO_RESIZE, HORIZONTAL_RESIZE, VERTICAL_RESIZE,
                DIAGONAL_RESIZE } ResizeMode;
 
+/*!
+ * \brief Structure containing the progression of a playing box, taken once per frame.
+ */
+struct ProgressionSample {
+  unsigned int boxID;       //!< The playing box.
+  float progression;        //!< The box progress ratio.
+  unsigned int currentTime; //!< The execution time in ms when the ratio was taken.
+};
+
 class MaquetteScene : public QGraphicsScene
 
 {
@@ -166,6 +179,29 @@ class MaquetteScene : public QGraphicsScene
      */
     BasicBox *getBox(unsigned int box);
 
+    /*!
+     * \brief Gets the current main resizing box.
+     *
+     * \return the box, NULL if none or if it was removed since the resizing began
+     */
+    BasicBox *resizingBox();
+
+    /*!
+     * \brief Gets the box under a point, if it is the topmost item there.
+     *
+     * \param pos : the point in scene coordinates
+     * \return the box, NULL if the topmost item is not a box
+     */
+    BasicBox *boxAt(const QPointF &pos);
+
+    /*!
+     * \brief Gets the boxes whose bounding rectangle intersects a rectangle, using the scene index.
+     *
+     * \param rect : the rectangle in scene coordinates
+     * \param boxes : the list to be filled with the boxes, topmost first
+     */
+    void boxesIntersecting(const QRectF &rect, QList<BasicBox*> &boxes);
+
     /*!
      * \brief Requests the maquette for the relation identified by ID.
      *
@@ -225,7 +261,7 @@ class MaquetteScene : public QGraphicsScene
     inline QList<TriggerPoint *> *triggersQueueList(){ return _triggersQueueList; }
 
     /*!
-     * \brief Adds a trigger to the queue list.
+     * \brief Adds a trigger to the queue list, sorted by trigger point date.
      *
      * \param trgID : trigger point to add.
      */
@@ -264,6 +300,14 @@ class MaquetteScene : public QGraphicsScene
      */
     unsigned int addParentBox(unsigned int ID);
 
+    /*!
+     * \brief Adds existing parent boxes as items to the maquette.
+     * The items index of the scene is built once, after all boxes are added.
+     *
+     * \param IDs : the IDs of the boxes
+     */
+    void addParentBoxes(const std::vector<unsigned int> &IDs);
+
     /*!
      * \brief Adds a new relation as an item to the maquette.
      *
@@ -340,6 +384,74 @@ class MaquetteScene : public QGraphicsScene
      */
     void boxResized();
 
+    /*!
+     * \brief Requests the moves of the current selection to be solved by the Engines.
+     *
+     * With deferred editing, the boxes keep the position given by the mouse until
+     * the next frame, where only the latest request is solved.
+     */
+    void postSelectionMoved();
+
+    /*!
+     * \brief Requests the resize of the resizing box to be solved by the Engines.
+     *
+     * With deferred editing, only the latest request is solved at the next frame.
+     */
+    void postBoxResized();
+
+    /*!
+     * \brief Solves at once the requested moves and resizes not solved yet.
+     */
+    void flushPendingEdits();
+
+    /*!
+     * \brief Sets if moves and resizes during drags are solved once per frame.
+     *
+     * \param deferred : true to solve once per frame, false to solve on each mouse event
+     */
+    void setDeferredEditing(bool deferred);
+    inline bool
+    deferredEditing() const { return _deferredEditing; }
+
+    /*!
+     * \brief Requests the widgets of a box to be built at the next frame.
+     * Called when a box without contents is shown.
+     *
+     * \param ID : the box ID
+     */
+    void requestBoxContents(unsigned int ID);
+
+    /*!
+     * \brief Marks the contents of a box as the most recently used ones.
+     *
+     * \param ID : the box ID
+     */
+    void touchBoxContents(unsigned int ID);
+
+    /*!
+     * \brief Releases the least recently used contents beyond the budget.
+     * Contents of selected boxes and of boxes shown in the view are kept.
+     */
+    void trimBoxContents();
+
+    /*!
+     * \brief Sets if the widgets of the boxes are built only when shown or selected.
+     *
+     * \param lazy : true to build the widgets on demand, false to build them all
+     */
+    void setLazyContents(bool lazy);
+    inline bool
+    lazyContents() const { return _lazyContents; }
+
+    /*!
+     * \brief Sets the number of boxes keeping their widgets in lazy mode.
+     *
+     * \param budget : the maximum number of boxes with contents
+     */
+    void setContentsBudget(unsigned int budget);
+    inline unsigned int
+    contentsBudget() const { return _contentsBudget; }
+
     /*!
      * \brief Sets the abstractBox of AttributesEditor.
      *
@@ -459,6 +571,7 @@ class MaquetteScene : public QGraphicsScene
 
     /*!
      * \brief Gets the box progress ratio.
+     * While playing, the ratio is read from the snapshot taken for the current frame.
      *
      * \return the box progress ratio.
      */
@@ -529,9 +642,36 @@ class MaquetteScene : public QGraphicsScene
 
     /*!
      * \brief Updates the boxes currently playing.
+     * The progression of every playing box is taken once from the engines, then
+     * used by every box and by the progress bar during the frame.
      */
     void updatePlayingBoxes();
 
+    /*!
+     * \brief Selects how the playing display is refreshed.
+     * In overlay mode, only the play head strips and the progress bands of the playing boxes
+     * are repainted. Otherwise the whole scene is invalidated on each frame.
+     *
+     * \param overlay : the new playhead overlay mode
+     */
+    void setPlayheadOverlay(bool overlay);
+
+    /*!
+     * \brief Determines if the playing display is refreshed in overlay mode.
+     *
+     * \return the playhead overlay mode
+     */
+    inline bool
+    playheadOverlay() const { return _playheadOverlay; }
+
+    /*!
+     * \brief Gets the area repainted by the playing display during the last second.
+     *
+     * \return the number of pixels repainted per second
+     */
+    inline unsigned int
+    repaintedPixelsPerSecond() const { return _repaintedPixelsPerSecond; }
+
     /*!
      * \brief Set the stored playing state of a box.
      *
@@ -557,6 +697,9 @@ class MaquetteScene : public QGraphicsScene
     static const int MIN_BOX_WIDTH = 50;
     static const int MIN_BOX_HEIGHT = 30;
     static const int NAME_POINT_SIZE = 20;
+    static const int EDIT_FRAME_INTERVAL = 16; //!< Interval in ms between two solvings during drags.
+    static const unsigned int CONTENTS_BUDGET = 256; //!< Default number of boxes keeping their widgets.
+    static const unsigned int CONTENTS_PER_FRAME = 32; //!< Number of boxes whose widgets are built per frame.
 
     inline AttributesEditor *
     editor(){ return _editor; }
@@ -634,6 +777,15 @@ class MaquetteScene : public QGraphicsScene
      */
     virtual void contextMenuEvent(QGraphicsSceneContextMenuEvent * event);
 
+    /*!
+     * \brief Redefinition of QObject::timerEvent().
+     * Solves the moves and resizes requested since the last frame,
+     * and builds the requested box contents.
+     *
+     * \param event : contains the information about the event
+     */
+    virtual void timerEvent(QTimerEvent *event);
+
   signals:
     void stopPlaying();
     void accelerationValueChanged(double value);
@@ -710,6 +862,20 @@ class MaquetteScene : public QGraphicsScene
      */
     unsigned int findMother(const QPointF &topLeft, const QPointF &size);
 
+    /*!
+     * \brief Accounts an area repainted by the playing display.
+     * Only the visible part of the area is taken into account.
+     *
+     * \param rect : the repainted area in scene coordinates
+     */
+    void countRepaintedArea(const QRectF &rect);
+
+    /*!
+     * \brief Builds the widgets of the boxes requested since the last frame,
+     * at most CONTENTS_PER_FRAME of them, then trims the contents to the budget.
+     */
+    void materializeRequestedContents();
+
     /*!
      * \brief Adds a box.
      *
@@ -768,10 +934,25 @@ class MaquetteScene : public QGraphicsScene
     int _savedInteractionMode;         //!< Saved interation mode.
     int _savedBoxMode;                 //!< Saved box interation mode.
 
-    unsigned int _resizeBox;           //!< During a resizing operation, the concerned box
+    EntityStore<BasicBox*>::Handle _resizeBox; //!< During a resizing operation, the concerned box
+    bool _deferredEditing;             //!< Handles if drags are solved once per frame.
+    bool _selectionMovePending;        //!< Handles if a move of the selection waits to be solved.
+    bool _resizePending;               //!< Handles if a resize waits to be solved.
+    QBasicTimer _editTimer;            //!< Timer solving the pending moves and resizes.
+    bool _lazyContents;                //!< Handles if box widgets are built on demand.
+    unsigned int _contentsBudget;      //!< Number of boxes keeping their widgets.
+    std::set<unsigned int> _contentsRequests; //!< Boxes waiting for their widgets.
+    std::list<unsigned int> _contentsUsage;   //!< Boxes with widgets, least recently used first.
+    std::map<unsigned int, std::list<unsigned int>::iterator> _contentsUsageIndex; //!< Position of boxes in _contentsUsage.
+    QBasicTimer _contentsTimer;        //!< Timer building the requested box widgets.
     bool _clicked;                     //!< Handles if a click just occured.
     bool _playing;                     //!< Handles playing state.
     bool _paused;                      //!< Handles paused state.
+    bool _playheadOverlay;             //!< Handles playhead overlay mode.
+
+    qreal _repaintedArea;              //!< Area repainted since the last measure.
+    QElapsedTimer _repaintClock;       //!< Clock measuring the repainted area.
+    unsigned int _repaintedPixelsPerSecond; //!< Last repainted area measure.
 
     unsigned int _startingValue;       //!< Starting time in ms.
 
@@ -782,8 +963,10 @@ class MaquetteScene : public QGraphicsScene
     AbstractRelation * _relation;
 
     std::map<unsigned int, BasicBox*> _playingBoxes; //!< Handles the whole set of currently playing boxes
+    std::vector<ProgressionSample> _progressionSnapshot; //!< Progressions of the playing boxes for the current frame, sorted by ID.
+    unsigned int _snapshotTime;        //!< Execution time in ms of the current frame.
 
-    PlayingThread *_playThread; //!< The thread handling playing.
+    PlaybackClock *_playbackClock; //!< The frame clock refreshing the display while playing.
 
     TimeBarWidget *_timeBar;
     QGraphicsProxyWidget *_timeBarProxy;
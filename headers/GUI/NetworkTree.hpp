@@ -52,6 +52,7 @@
 #include "DeviceEdit.hpp"
 #include <QPair>
 #include <QMap>
+#include <QHash>
 
 using std::vector;
 using std::string;
@@ -110,13 +111,13 @@ class NetworkTree : public QTreeWidget
     setStartOSCMessages(NetworkMessages *messages)
     {
       _OSCStartMessages->clear();
-      _OSCStartMessages = new NetworkMessages(messages->getMessages());
+      _OSCStartMessages = new NetworkMessages(messages);
     }
     inline void
     setStartMessages(NetworkMessages *messages)
     {
       _startMessages->clear();
-      _startMessages = new NetworkMessages(messages->getMessages());
+      _startMessages = new NetworkMessages(messages);
     }
 
     /*!
@@ -127,13 +128,13 @@ class NetworkTree : public QTreeWidget
     setEndMessages(NetworkMessages *messages)
     {
       _endMessages->clear();
-      _endMessages = new NetworkMessages(messages->getMessages());
+      _endMessages = new NetworkMessages(messages);
     }
     inline void
     setEndOSCMessages(NetworkMessages *messages)
     {
       _OSCEndMessages->clear();
-      _OSCEndMessages = new NetworkMessages(messages->getMessages());
+      _OSCEndMessages = new NetworkMessages(messages);
     }
 
     /*!
@@ -482,7 +483,7 @@ class NetworkTree : public QTreeWidget
     void assignItem(QTreeWidgetItem *item, Data data);
     void updateOSCAddresses();
 
-    QMap<QTreeWidgetItem *, string> _addressMap;
+    QHash<AddressID, QTreeWidgetItem *> _addressItems; //!< Explored item of each address.
     QList<QTreeWidgetItem*> _nodesWithSelectedChildren;
     QMap<QTreeWidgetItem *, Data> _assignedItems;
     QList<QTreeWidgetItem*> _nodesWithSomeChildrenAssigned;
@@ -121,7 +121,7 @@ class ParentBox : public BasicBox
     /*!
      * \brief Gets the whole map of children.
      */
-    std::map<unsigned int, BasicBox*> children() const;
+    const std::map<unsigned int, BasicBox*> &children() const;
 
     /*!
      * \brief Determines if the box has any child.
@@ -139,6 +139,11 @@ class ParentBox : public BasicBox
     virtual void updateDisplay(QString displayMode);
 
   protected:
+    /*!
+     * \brief Creates the widgets of the box, adding the sub-scenario mode to the combo box.
+     */
+    virtual void createContents();
+
     /*!
      * \brief Plays individually the parent box.
      */
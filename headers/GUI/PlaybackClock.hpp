@@ -0,0 +1,139 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef PLAYBACK_CLOCK_HPP
+#define PLAYBACK_CLOCK_HPP
+
+/*!
+ * \file PlaybackClock.hpp
+ */
+
+#include <QObject>
+#include <QBasicTimer>
+#include <QElapsedTimer>
+
+class MaquetteScene;
+class QTimerEvent;
+
+/*!
+ * \class PlaybackClock
+ *
+ * \brief Frame clock refreshing the playing display from the GUI thread.
+ *
+ * The clock ticks once per display frame and measures time with a monotonic
+ * clock. A frame is only rendered if the play head moved by at least one pixel,
+ * and ticks arriving later than a frame interval are accounted as dropped frames.
+ */
+class PlaybackClock : public QObject
+{
+  Q_OBJECT
+
+  public:
+    PlaybackClock(MaquetteScene *scene);
+
+    /*!
+     * \brief Determines if the clock is currently ticking.
+     *
+     * \return the running state of the clock
+     */
+    bool isActive() const;
+
+    /*!
+     * \brief Sets the interval between two frames.
+     *
+     * \param interval : the frame interval in ms
+     */
+    void setFrameInterval(int interval);
+
+    /*!
+     * \brief Gets the interval between two frames.
+     *
+     * \return the frame interval in ms
+     */
+    inline int
+    frameInterval() const { return _frameInterval; }
+
+    /*!
+     * \brief Gets the number of frames rendered since the last start.
+     */
+    inline unsigned int
+    renderedFrames() const { return _renderedFrames; }
+
+    /*!
+     * \brief Gets the number of frames skipped because nothing moved since the last start.
+     */
+    inline unsigned int
+    skippedFrames() const { return _skippedFrames; }
+
+    /*!
+     * \brief Gets the number of frames missed because a tick came too late since the last start.
+     */
+    inline unsigned int
+    droppedFrames() const { return _droppedFrames; }
+
+    //! Default frame interval in ms, matching a 60 Hz display.
+    static const int DEFAULT_FRAME_INTERVAL = 16;
+
+  public slots:
+    /*!
+     * \brief Starts ticking. Can be called from any thread.
+     */
+    void start();
+
+    /*!
+     * \brief Stops ticking. Can be called from any thread.
+     */
+    void stop();
+
+  protected:
+    /*!
+     * \brief Redefinition of QObject::timerEvent(). Handles a frame tick.
+     *
+     * \param event : the timer event
+     */
+    virtual void timerEvent(QTimerEvent *event);
+
+  private:
+    MaquetteScene *_scene;        //!< The scene refreshed.
+    QBasicTimer _timer;           //!< The frame timer.
+    QElapsedTimer _clock;         //!< Monotonic clock measuring frames.
+    qint64 _lastTick;             //!< Date of the last tick in ms.
+    int _frameInterval;           //!< Interval between two frames in ms.
+    int _lastPlayheadX;           //!< Play head position rendered during the last frame.
+    unsigned int _renderedFrames; //!< Frames rendered since start.
+    unsigned int _skippedFrames;  //!< Frames skipped since start.
+    unsigned int _droppedFrames;  //!< Frames dropped since start.
+};
+#endif
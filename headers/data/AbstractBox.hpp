@@ -152,13 +152,13 @@ class AbstractBox : public Abstract
      * \brief Gets the messages to send at box start.
      * \return the messages to send at box start
      */
-    inline std::vector<std::string> firstMsgs() const { return _firstMsgs; }
+    inline const std::vector<std::string> &firstMsgs() const { return _firstMsgs; }
 
     /*!
      * \brief Gets the messages to send at box end.
      * \return the messages to send at box end
      */
-    inline std::vector<std::string> lastMsgs() const { return _lastMsgs; }
+    inline const std::vector<std::string> &lastMsgs() const { return _lastMsgs; }
 
     /*!
      * \brief Gets the messages to send at box start.
@@ -53,6 +53,7 @@
 #include <string>
 #include <map>
 #include "Abstract.hpp"
+#include "AddressTable.hpp"
 #include "CSPTypes.hpp"
 #include <QPoint>
 #include <QColor>
@@ -84,7 +85,7 @@ class AbstractCurve : public Abstract
 
   private:
     unsigned int _boxID;      //!< Box ID.
-    std::string _address;     //!< Address of the curve.
+    AddressID _address;       //!< Address of the curve.
     unsigned int _argPosition;
     unsigned int _sampleRate; //!< Curve sample rate.
     bool _redundancy;         //!< Handles curve's redundancy
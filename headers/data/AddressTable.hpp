@@ -0,0 +1,127 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef ADDRESS_TABLE_HPP
+#define ADDRESS_TABLE_HPP
+
+/*!
+ * \file AddressTable.hpp
+ */
+
+#include <QString>
+#include <string>
+
+//! Identifier of an interned network address.
+typedef unsigned int AddressID;
+
+/*!
+ * \class AddressTable
+ *
+ * \brief Process-wide table of the network addresses used by the composition.
+ *
+ * Each address is stored once and identified by an integer, so that the data
+ * layer compares and hashes addresses as integers. The address is kept both as
+ * a QString and as a std::string, already split into its device and its path,
+ * to avoid conversions when messages are sent.
+ *
+ * IDs are never reused, and the table can be used from any thread. Getting an
+ * address from its ID takes no lock.
+ */
+class AddressTable
+{
+  public:
+    /*!
+     * \brief Gets the ID of an address, adding the address to the table if needed.
+     *
+     * \param address : the address, of the form device/path
+     * \return the ID of the address, NO_ADDRESS if the table is full
+     */
+    static AddressID intern(const QString &address);
+    static AddressID intern(const std::string &address);
+
+    /*!
+     * \brief Gets the ID of an address without adding it.
+     *
+     * \param address : the address
+     * \return the ID of the address, NO_ADDRESS if not in the table
+     */
+    static AddressID find(const QString &address);
+
+    /*!
+     * \brief Gets an address.
+     *
+     * \param ID : the ID of the address
+     * \return the address, empty for NO_ADDRESS or an ID not in the table
+     */
+    static const QString &address(AddressID ID);
+
+    /*!
+     * \brief Gets an address as a std::string.
+     *
+     * \param ID : the ID of the address
+     * \return the address, empty for NO_ADDRESS or an ID not in the table
+     */
+    static const std::string &stdAddress(AddressID ID);
+
+    /*!
+     * \brief Gets the device of an address.
+     *
+     * \param ID : the ID of the address
+     * \return the part of the address before the first '/', empty if none
+     */
+    static const std::string &device(AddressID ID);
+
+    /*!
+     * \brief Gets the path of an address in its device.
+     *
+     * \param ID : the ID of the address
+     * \return the part of the address from the first '/', empty for an ID not in the table
+     */
+    static const std::string &path(AddressID ID);
+
+    /*!
+     * \brief Gets the number of addresses in the table.
+     *
+     * \return the number of addresses
+     */
+    static unsigned int size();
+
+    //! ID of an address not in the table.
+    static const AddressID NO_ADDRESS = ~0U;
+
+  private:
+    AddressTable();
+};
+#endif
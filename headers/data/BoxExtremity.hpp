@@ -1,10 +1,6 @@
 /*
  * Copyright: LaBRI / SCRIME
  *
- * Authors: Luc Vercellin (08/03/2010)
- *
- * luc.vercellin@labri.fr
- *
  * This software is a computer program whose purpose is to provide
  * notation/composition combining synthesized as well as recorded
  * sounds, providing answers to the problem of notation and, drawing,
@@ -37,27 +33,19 @@
  * The fact that you are presently reading this means that you have had
  * knowledge of the CeCILL license and that you accept its terms.
  */
+#ifndef BOX_EXTREMITY_HPP
+#define BOX_EXTREMITY_HPP
 
 /*!
- * \file PlayingThread.cpp
+ * \file BoxExtremity.hpp
  */
 
-#include "PlayingThread.hpp"
-#include "MaquetteScene.hpp"
-
-PlayingThread::PlayingThread(MaquetteScene *scene)
-  : QThread()
-{
-  _scene = scene;
-}
+#include "CSPTypes.hpp"
 
-void
-PlayingThread::run()
-{
-  while (_scene->playing()) {
-      _scene->updatePlayingBoxes();
-      _scene->updateProgressBar();
+/*!
+ * \brief Enum used to manage various box extremities.
+ */
+enum BoxExtremity { NO_EXTREMITY = -1, BOX_START = BEGIN_CONTROL_POINT_INDEX,
+                    BOX_END = END_CONTROL_POINT_INDEX };
 
-      msleep(10);
-    }
-}
+#endif
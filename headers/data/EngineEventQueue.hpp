@@ -0,0 +1,154 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef ENGINE_EVENT_QUEUE_HPP
+#define ENGINE_EVENT_QUEUE_HPP
+
+/*!
+ * \file EngineEventQueue.hpp
+ */
+
+#include <QAtomicInt>
+
+/*!
+ * \brief Structure containing an event raised by an Engines callback.
+ */
+struct EngineEvent {
+  //! Enum containing the kinds of events raised by Engines.
+  enum Type { CROSSED_TRANSITION, CROSSED_TRIGGER_POINT, NETWORK_UPDATE, EXECUTION_FINISHED };
+
+  //! Enum containing the transport commands received from the network.
+  enum Command { NO_COMMAND, PLAY, STOP, REWIND, START_POINT, SPEED, NEXT_TRIGGER };
+
+  Type type;            //!< The kind of event.
+  unsigned int ID;      //!< The box crossed or the trigger point triggered.
+  unsigned int CPIndex; //!< The control point crossed.
+  bool waiting;         //!< The waiting state of the trigger point.
+  Command command;      //!< The transport command received.
+  unsigned int date;    //!< The date argument of the transport command, in ms.
+  double speed;         //!< The speed argument of the transport command.
+  qint64 dueTime;       //!< The time the transport command is scheduled for, in us since the epoch (0 for immediately).
+
+  EngineEvent(Type typeArg = EXECUTION_FINISHED, unsigned int IDArg = 0, unsigned int CPIndexArg = 0, bool waitingArg = false)
+    : type(typeArg), ID(IDArg), CPIndex(CPIndexArg), waiting(waitingArg), command(NO_COMMAND), date(0), speed(1.), dueTime(0)
+  {
+  }
+};
+
+/*!
+ * \class EngineEventQueue
+ *
+ * \brief Bounded lock-free queue of Engines events.
+ *
+ * Events are pushed by a single producer thread (an Engines thread) and
+ * popped by a single consumer thread (the GUI thread). The producer never
+ * blocks : when the queue is full, events are dropped and counted.
+ * The end of the execution is never dropped : it is kept as a flag beside the
+ * queue, taken by the consumer before it pops the events.
+ */
+class EngineEventQueue
+{
+  public:
+    /*!
+     * \brief Creates a queue.
+     *
+     * \param capacity : the maximum number of events, rounded up to a power of two
+     */
+    EngineEventQueue(unsigned int capacity = DEFAULT_CAPACITY);
+    ~EngineEventQueue();
+
+    /*!
+     * \brief Adds an event at the end of the queue. Producer side only.
+     *
+     * \param event : the event to add
+     * \return false if the queue is full and the event was dropped
+     */
+    bool push(const EngineEvent &event);
+
+    /*!
+     * \brief Takes the end of the execution, if pushed since the last call. Consumer side only.
+     *
+     * Events pushed before the end of the execution are in the queue once this returns true.
+     *
+     * \return true if an EXECUTION_FINISHED event was pushed
+     */
+    bool takeExecutionFinished();
+
+    /*!
+     * \brief Removes the first event of the queue. Consumer side only.
+     *
+     * \param event : the event to be filled
+     * \return false if the queue is empty
+     */
+    bool pop(EngineEvent &event);
+
+    /*!
+     * \brief Determines if the queue is empty.
+     *
+     * \return true if no event is waiting
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Gets the maximum number of events.
+     *
+     * \return the capacity of the queue
+     */
+    inline unsigned int
+    capacity() const { return _capacity; }
+
+    /*!
+     * \brief Gets the number of events dropped because the queue was full.
+     *
+     * \return the number of dropped events
+     */
+    unsigned int droppedEvents() const;
+
+    //! Default maximum number of events.
+    static const unsigned int DEFAULT_CAPACITY = 1024;
+
+  private:
+    EngineEventQueue(const EngineEventQueue &);
+    EngineEventQueue &operator=(const EngineEventQueue &);
+
+    EngineEvent *_events;   //!< The events storage.
+    unsigned int _capacity; //!< The maximum number of events.
+    int _indexMask;         //!< Mask wrapping indices over twice the capacity.
+    QAtomicInt _head;       //!< Index of the next event to pop, written by the consumer.
+    QAtomicInt _tail;       //!< Index of the next event to push, written by the producer.
+    QAtomicInt _dropped;    //!< Number of events dropped.
+    QAtomicInt _finished;   //!< Set when an EXECUTION_FINISHED event is pushed.
+};
+#endif
@@ -0,0 +1,330 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef ENTITY_STORE_HPP
+#define ENTITY_STORE_HPP
+
+/*!
+ * \file EntityStore.hpp
+ */
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/*!
+ * \class EntityStore
+ *
+ * \brief Entities of a composition (boxes, relations, trigger points) stored by ID.
+ *
+ * Entities are kept contiguous, so that iterating over them does not follow
+ * pointers, and each ID points to the position of its entity, so that lookup
+ * is done in constant time. Removing an entity moves the last one in its
+ * place : iteration order is not the order of IDs. Positions of IDs are
+ * released when entities with the largest IDs are removed.
+ *
+ * IDs are given by the Engines, which reuse the IDs of removed entities. Each
+ * stored entity gets a new generation, so that a Handle kept on an entity no
+ * longer resolves once this entity is removed, even if its ID is reused.
+ *
+ * The interface follows std::map : iterators point to (ID, entity) pairs.
+ */
+template <typename T>
+class EntityStore
+{
+  public:
+    //! Generation of no entity.
+    static const unsigned int NO_GENERATION = 0;
+
+    /*!
+     * \brief Reference to a stored entity, resolving only to this entity.
+     */
+    struct Handle {
+      unsigned int ID;         //!< The entity ID.
+      unsigned int generation; //!< The generation of the entity, NO_GENERATION if none.
+
+      Handle(unsigned int IDArg = 0, unsigned int generationArg = NO_GENERATION)
+        : ID(IDArg), generation(generationArg) {}
+    };
+
+    EntityStore()
+      : _nextGeneration(NO_GENERATION + 1) {}
+
+    typedef std::pair<unsigned int, T> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    inline iterator
+    begin(){ return _entities.begin(); }
+    inline iterator
+    end(){ return _entities.end(); }
+    inline const_iterator
+    begin() const { return _entities.begin(); }
+    inline const_iterator
+    end() const { return _entities.end(); }
+
+    inline unsigned int
+    size() const { return _entities.size(); }
+    inline bool
+    empty() const { return _entities.empty(); }
+
+    /*!
+     * \brief Finds the entity of an ID.
+     *
+     * \param ID : the entity ID
+     * \return an iterator on the entity, end() if none
+     */
+    iterator
+    find(unsigned int ID)
+    {
+      const Slot *slot = slotOf(ID);
+      return slot == NULL ? _entities.end() : _entities.begin() + slot->index;
+    }
+
+    const_iterator
+    find(unsigned int ID) const
+    {
+      const Slot *slot = slotOf(ID);
+      return slot == NULL ? _entities.end() : _entities.begin() + slot->index;
+    }
+
+    /*!
+     * \brief Finds the entity of a handle.
+     *
+     * \param handle : the handle
+     * \return an iterator on the entity, end() if the entity of the handle was removed
+     */
+    iterator
+    find(const Handle &handle)
+    {
+      const Slot *slot = slotOf(handle.ID);
+      return slot == NULL || slot->generation != handle.generation ? _entities.end() : _entities.begin() + slot->index;
+    }
+
+    const_iterator
+    find(const Handle &handle) const
+    {
+      const Slot *slot = slotOf(handle.ID);
+      return slot == NULL || slot->generation != handle.generation ? _entities.end() : _entities.begin() + slot->index;
+    }
+
+    /*!
+     * \brief Gets a handle on the entity of an ID.
+     *
+     * \param ID : the entity ID
+     * \return the handle, resolving to no entity if the ID has none
+     */
+    Handle
+    handle(unsigned int ID) const
+    {
+      const Slot *slot = slotOf(ID);
+      return Handle(ID, slot == NULL ? (unsigned int)NO_GENERATION : slot->generation);
+    }
+
+    /*!
+     * \brief Determines if an ID has an entity.
+     *
+     * \param ID : the entity ID
+     * \return true if the ID has an entity
+     */
+    inline bool
+    contains(unsigned int ID) const { return find(ID) != end(); }
+    inline bool
+    contains(const Handle &handle) const { return find(handle) != end(); }
+
+    /*!
+     * \brief Gets the entity of an ID, inserting a default one if none.
+     * Like with std::map, the entities iterators are invalidated by an insertion.
+     *
+     * \param ID : the entity ID
+     * \return a reference to the entity
+     */
+    T &
+    operator[](unsigned int ID)
+    {
+      Slot &slot = slotAt(ID);
+      if (slot.index == NO_INDEX) {
+          slot.index = _entities.size();
+          slot.generation = _nextGeneration++;
+          if (_nextGeneration == NO_GENERATION) {
+              ++_nextGeneration;
+            }
+          _entities.push_back(value_type(ID, T()));
+        }
+      return _entities[slot.index].second;
+    }
+
+    /*!
+     * \brief Removes an entity.
+     *
+     * \param it : an iterator on the entity
+     * \return an iterator on the entity moved in its place, end() if none
+     */
+    iterator
+    erase(iterator it)
+    {
+      unsigned int index = it - _entities.begin();
+      releaseSlot(it->first);
+      if (index + 1 != _entities.size()) {
+          _entities[index] = _entities.back();
+          slotAt(_entities[index].first).index = index;
+        }
+      _entities.pop_back();
+      return _entities.begin() + index;
+    }
+
+    /*!
+     * \brief Removes the entity of an ID.
+     *
+     * \param ID : the entity ID
+     * \return the number of entities removed
+     */
+    unsigned int
+    erase(unsigned int ID)
+    {
+      iterator it = find(ID);
+      if (it == end()) {
+          return 0;
+        }
+      erase(it);
+      return 1;
+    }
+
+    /*!
+     * \brief Reserves room for a number of entities, and for the positions of IDs up to this number.
+     *
+     * \param count : the number of entities
+     */
+    void
+    reserve(unsigned int count)
+    {
+      _entities.reserve(count);
+      _slots.reserve(count < MAX_DIRECT_ID ? count : MAX_DIRECT_ID);
+    }
+
+    /*!
+     * \brief Removes every entity. Handles on them no longer resolve.
+     */
+    void
+    clear()
+    {
+      _entities.clear();
+      _slots.clear();
+      _farSlots.clear();
+    }
+
+    /*!
+     * \brief Gets the IDs of the entities, sorted.
+     *
+     * \param IDs : the vector to be filled
+     */
+    void
+    sortedIDs(std::vector<unsigned int> &IDs) const
+    {
+      IDs.clear();
+      IDs.reserve(_entities.size());
+      for (const_iterator it = _entities.begin(); it != _entities.end(); ++it) {
+          IDs.push_back(it->first);
+        }
+      std::sort(IDs.begin(), IDs.end());
+    }
+
+    //! IDs from which positions are not indexed directly but through a map.
+    static const unsigned int MAX_DIRECT_ID = 1 << 20;
+
+  private:
+    //! Index of an ID without entity.
+    static const unsigned int NO_INDEX = ~0U;
+
+    //! Position and generation of the entity of an ID.
+    struct Slot {
+      unsigned int index;      //!< Position of the entity, NO_INDEX if none.
+      unsigned int generation; //!< Generation of the entity.
+
+      Slot()
+        : index(NO_INDEX), generation(NO_GENERATION) {}
+    };
+
+    //! Gets the slot of an ID, NULL if the ID has no entity.
+    const Slot *
+    slotOf(unsigned int ID) const
+    {
+      const Slot *slot = NULL;
+      if (ID < MAX_DIRECT_ID) {
+          slot = ID < _slots.size() ? &_slots[ID] : NULL;
+        }
+      else {
+          typename std::map<unsigned int, Slot>::const_iterator it = _farSlots.find(ID);
+          slot = it == _farSlots.end() ? NULL : &it->second;
+        }
+      return slot == NULL || slot->index == NO_INDEX ? NULL : slot;
+    }
+
+    Slot &
+    slotAt(unsigned int ID)
+    {
+      if (ID < MAX_DIRECT_ID) {
+          if (ID >= _slots.size()) {
+              _slots.resize(ID + 1);
+            }
+          return _slots[ID];
+        }
+      return _farSlots[ID];
+    }
+
+    /*!
+     * \brief Forgets the position of an ID, shrinking the direct positions when it was the largest ID.
+     * Generations are not reused, so that forgotten slots need not be kept.
+     */
+    void
+    releaseSlot(unsigned int ID)
+    {
+      if (ID >= MAX_DIRECT_ID) {
+          _farSlots.erase(ID);
+          return;
+        }
+      _slots[ID] = Slot();
+      while (!_slots.empty() && _slots.back().index == NO_INDEX) {
+          _slots.pop_back();
+        }
+    }
+
+    std::vector<value_type> _entities;         //!< The entities, contiguous.
+    std::vector<Slot> _slots;                  //!< Positions of the entities by ID.
+    std::map<unsigned int, Slot> _farSlots;    //!< Positions of the entities whose ID is too large to be indexed directly.
+    unsigned int _nextGeneration;              //!< Generation of the next entity stored.
+};
+#endif
@@ -53,11 +53,23 @@
 #include <map>
 #include <string>
 #include <list>
+#include <set>
 #include <utility>
 #include <sstream>
 #include "NetworkMessages.hpp"
 #include "CSPTypes.hpp"
 #include "BasicBox.hpp"
+#include "EngineEventQueue.hpp"
+#include "ScoreFile.hpp"
+#include "TimelineIndex.hpp"
+#include "TriggerSchedule.hpp"
+#include "EntityStore.hpp"
+#include "RelationIndex.hpp"
+#include <QAtomicInt>
+#include <QBasicTimer>
+#include <QHostAddress>
+#include <QHostInfo>
+#include <QHash>
 
 //! Default network host.
 
@@ -91,6 +103,8 @@ class AbstractRelation;
 class Relation;
 class TriggerPoint;
 class QApplication;
+class QUdpSocket;
+class QTimerEvent;
 
 //! Enum containing various error messages.
 typedef enum { SUCCESS = 1, NO_MODIFICATION = 0, RETURN_ERROR = -1,
@@ -477,6 +491,16 @@ class Maquette : public QObject
      */
     bool sendMessage(const std::string &message);
 
+    /*!
+     * \brief Sends a set of messages, grouped by device.
+     * Messages of OSC devices are sent as one OSC bundle per device, with a shared timetag.
+     * Messages of other devices are sent one by one by the engines.
+     *
+     * \param messages : the messages to send, as (address, value) pairs
+     * \return the number of datagrams and messages successfully sent
+     */
+    unsigned int sendMessages(const std::vector<std::pair<AddressID, std::string> > &messages);
+
     /*!
      * \brief Adds a parent box to the maquette.
      *
@@ -501,7 +525,7 @@ class Maquette : public QObject
      *
      * \return the whole set of parent boxes
      */
-    std::map<unsigned int, ParentBox*> parentBoxes();
+    const EntityStore<ParentBox*> &parentBoxes() const;
 
     /*!
      * \brief Adds a new AntPost relation between 2 objects extremities.
@@ -587,6 +611,14 @@ class Maquette : public QObject
      */
     TriggerPoint* getTriggerPoint(unsigned int trgID);
 
+    /*!
+     * \brief Gets the date of a trigger point, from the engines dates of its box.
+     *
+     * \param trgID : the trigger point ID
+     * \return the date of the trigger point in ms
+     */
+    unsigned int triggerDate(unsigned int trgID);
+
     /*!
      * \brief Simulates a message reception for a trigger point.
      *
@@ -618,6 +650,25 @@ class Maquette : public QObject
      */
     bool updateBox(unsigned int boxID, const Coords &coord);
 
+    /*!
+     * \brief Begins an edition of several boxes.
+     *
+     * Until the matching commitEdit(), updateBox only records the new coordinates
+     * of the boxes. Editions can be nested, the outermost one being committed.
+     */
+    void beginEdit();
+
+    /*!
+     * \brief Commits the boxes coordinates recorded since beginEdit().
+     *
+     * Boxes are submitted to the Engines in a single pass, skipping the boxes already
+     * placed by the solving of another one, and graphical items are updated once at the end.
+     * Edited boxes always keep their recorded vertical position and height.
+     *
+     * \return false if the Engines refused one of the transformations
+     */
+    bool commitEdit();
+
     /*!
      * \brief Informs relations that boxes have been moved.
      */
@@ -662,6 +713,10 @@ class Maquette : public QObject
     /*!
      * \brief Saves the current composition into a file.
      *
+     * The file is written as XML (see ScoreFile) beside its destination, then
+     * renamed over it once complete, so that an interrupted save never leaves a
+     * truncated file.
+     *
      * \param fileName : the file to save current composition into
      */
     void save(const std::string &fileName);
@@ -669,6 +724,9 @@ class Maquette : public QObject
     /*!
      * \brief Loads a file into a new composition.
      *
+     * The file is read in a single pass before the composition is changed (see
+     * ScoreFile). XML files without the i-scoreSave doctype are loaded by loadOLD().
+     *
      * \param fileName : the file to load composition from
      */
     void load(const std::string &fileName);
@@ -719,6 +777,13 @@ class Maquette : public QObject
      */
     void startPlaying();
 
+    /*!
+     * \brief Handles on the GUI thread the events posted by Engines callbacks.
+     * Redundant events are collapsed : only the last transition crossed by each box
+     * and the last state of each trigger point are handled.
+     */
+    void processEngineEvents();
+
     /*!
      * \brief Stops the playing process.
      */
@@ -750,19 +815,143 @@ class Maquette : public QObject
      * \param trgID : trigger point ID
      */
     void crossedTriggerPoint(bool waiting, unsigned int trgID);
-    inline std::map<unsigned int, BasicBox*> getBoxes(){ return _boxes; }
+
+    /*!
+     * \brief Called by the callback when a transport command is received from the network.
+     * A command with a timetag in the future is scheduled for that instant.
+     *
+     * \param event : the transport command received
+     */
+    void networkUpdate(const EngineEvent &event);
+
+    /*!
+     * \brief Posts an event raised on the Engines execution thread.
+     * The event is handled later on the GUI thread by processEngineEvents().
+     *
+     * \param event : the event to post
+     */
+    void postEngineEvent(const EngineEvent &event);
+
+    /*!
+     * \brief Posts an event raised on the Engines network thread.
+     * The event is handled later on the GUI thread by processEngineEvents().
+     *
+     * \param event : the event to post
+     */
+    void postNetworkEvent(const EngineEvent &event);
+    inline const EntityStore<BasicBox*> &getBoxes() const { return _boxes; }
 
     /*!
      * \brief When a goto value is entered, the scenario before this value is simulated.
      * Messages (final state of each boxes) are sended to the engine.
      */
     void initSceneState();
+
+    /*!
+     * \brief Informs that the dates or messages of a box changed, or that the box was removed.
+     * The timeline index is updated from the box before the next scene state computation.
+     *
+     * \param boxID : the box changed
+     */
+    void invalidateBoxState(unsigned int boxID);
+
+    /*!
+     * \brief Sets the interval between two checkpoints of the scene state.
+     *
+     * \param interval : the interval in ms, 0 to disable checkpoints
+     */
+    void setCheckpointInterval(unsigned int interval);
+
+    /*!
+     * \brief Gets an estimation of the memory used by the scene state checkpoints.
+     *
+     * \return the memory used in bytes
+     */
+    unsigned int checkpointsMemory() const;
+
+    /*!
+     * \brief Sets the number of boxes of the score above which the scene state is computed
+     * directly from the boxes, using every processor, instead of from the timeline index.
+     *
+     * \param threshold : the number of boxes, 0 to disable parallel computation
+     */
+    void setParallelStateThreshold(unsigned int threshold);
+
+    //! Default number of boxes above which the scene state is computed in parallel.
+    static const unsigned int PARALLEL_STATE_THRESHOLD = 2000;
     void setStartMessageToSend(unsigned int boxID, QTreeWidgetItem *item, QString address);
     void setEndMessageToSend(unsigned int boxID, QTreeWidgetItem *item, QString address);
     std::vector<std::string> getPlugins();
     void removeNetworkDevice(string deviceName);
 
+  protected:
+    /*!
+     * \brief Redefinition of QObject::timerEvent() : executes the scheduled transport commands due.
+     */
+    virtual void timerEvent(QTimerEvent *event);
+
+  private slots:
+    /*!
+     * \brief Keeps the address of a network host once looked up. Failures are not kept.
+     *
+     * \param info : the result of the lookup
+     */
+    void hostResolved(const QHostInfo &info);
+
   private:
+    /*!
+     * \brief Requests the GUI thread to handle posted events, unless already requested.
+     */
+    void wakeUpEngineEvents();
+
+    /*!
+     * \brief Executes a transport command received from the network.
+     *
+     * \param event : the transport command
+     */
+    void executeTransportCommand(const EngineEvent &event);
+
+    /*!
+     * \brief Starts the timer waking up before the next scheduled transport command.
+     */
+    void scheduleNextTransportCommand();
+
+    /*!
+     * \brief Updates the timeline index from the boxes changed since the last update.
+     */
+    void updateTimeline();
+
+    /*!
+     * \brief Reschedules the trigger points of the boxes changed since the last update.
+     */
+    void updateTriggerSchedule();
+
+    /*!
+     * \brief Schedules a trigger point at the date of its control point.
+     *
+     * \param trgPnt : the trigger point
+     */
+    void scheduleTriggerPoint(TriggerPoint *trgPnt);
+
+    /*!
+     * \brief Gets the absolute date of a box extremity from the engines.
+     *
+     * \param boxID : the box
+     * \param extremity : the extremity of the box
+     * \return the date in ms
+     */
+    unsigned int controlPointDate(unsigned int boxID, BoxExtremity extremity);
+
+    /*!
+     * \brief Mutes a control point of a set of boxes, unmuting the boxes previously muted and not in the set.
+     * Only the boxes whose muting state changes are sent to the engines.
+     *
+     * \param muted : the boxes whose control point is muted, to be updated
+     * \param toMute : the boxes whose control point has to be muted
+     * \param CPIndex : the control point index
+     */
+    void updateMutingStates(std::set<unsigned int> &muted, const std::vector<unsigned int> &toMute, unsigned int CPIndex);
+
     /*!
      * \brief Generates the triggerQueueList.
      */
@@ -782,26 +971,51 @@ class Maquette : public QObject
      */
     unsigned int addParentBox(unsigned int ID, const QPointF & corner1, const QPointF & corner2, const std::string &name,
                               unsigned int mother);
-    unsigned int addParentBox(unsigned int ID, const unsigned int date, const unsigned int topLeftY, const unsigned int sizeY, const unsigned int duration, const std::string &name,
-                              unsigned int mother, QColor color);
+
+    /*!
+     * \brief Adds the parent boxes of a score, whose IDs are already known by the Engines.
+     *
+     * The messages of all boxes are fetched from the Engines first, then the boxes are
+     * created, and mothers are linked once every box exists. Graphical items are not
+     * added to the scene.
+     *
+     * \param boxes : the boxes of the score
+     * \param IDs : filled with the IDs of the added boxes
+     * \return the number of boxes ignored because of an unavailable type
+     */
+    unsigned int addParentBoxes(const std::vector<ScoreFile::Box> &boxes, std::vector<unsigned int> &IDs);
 
     string extractAddress(string msg);
     string extractValue(string msg);
 
     /*!
-     * \brief Saves a box into doc.
+     * \brief Sends an OSC datagram to a device, its network host being resolved beforehand.
+     *
+     * A host not resolved yet is looked up, and the datagram is not sent.
+     *
+     * \param data : the datagram
+     * \param device : the device to send to
+     * \return true if the datagram could be sent
+     */
+    bool sendOSCDatagram(const QByteArray &data, const MyDevice &device);
+
+    /*!
+     * \brief Resolves a network host without blocking.
      *
-     * \param ID : the ID of the box to be saved
+     * A numeric address is known at once, a host name is looked up asynchronously
+     * unless already being looked up.
+     *
+     * \param host : the host name or address
      */
-    void saveBox(unsigned int ID);
+    void resolveHost(const std::string &host);
 
     /*!
-     * \brief Update curves for a box by specifying star end end messages.
+     * \brief Update curves for a box by specifying start and end values.
      *
-     * \param startMsgs : the start messages of the box
-     * \param endMsgs : the end messages of the box
+     * \param startValues : the start values of the box, by address
+     * \param endValues : the end values of the box, by address
      */
-    void updateCurves(unsigned int boxID, const std::vector<std::string> &startMsgs, const std::vector<std::string> &endMsgs);
+    void updateCurves(unsigned int boxID, const QHash<AddressID, MessageValue> &startValues, const QHash<AddressID, MessageValue> &endValues);
 
     /*!
      * \brief Updates a set of boxes from Engines coordinates.
@@ -817,19 +1031,22 @@ class Maquette : public QObject
     Engines *_engines;
 
     //! The map of boxes (identified by IDs) managed by the maquette.
-    std::map<unsigned int, BasicBox*> _boxes;
+    EntityStore<BasicBox*> _boxes;
 
     //! The map of parent boxes (identified by IDs) managed by the maquette.
-    std::map<unsigned int, ParentBox*> _parentBoxes;
+    EntityStore<ParentBox*> _parentBoxes;
 
     //! The map handling a set of control points for each box managed by the maquette.
     std::map<unsigned int, std::pair<unsigned int, unsigned int> > _controlPoints;
 
     //! The set of relations managed by the maquette.
-    std::map<unsigned int, Relation*> _relations;
+    EntityStore<Relation*> _relations;
+
+    //! The relations indexed by the boxes they link.
+    RelationIndex _relationIndex;
 
     //! The set of triggers points managed by the maquette.
-    std::map<unsigned int, TriggerPoint*> _triggerPoints;
+    EntityStore<TriggerPoint*> _triggerPoints;
 
     //! The next ID to be used for sequential name purpose
 //  unsigned int _currentID;
@@ -842,11 +1059,37 @@ class Maquette : public QObject
     std::vector<unsigned int> _listeningPorts;
     std::vector<std::string> _plugins;
 
+    QUdpSocket *_oscSocket;                         //!< Socket sending OSC bundles.
+    std::map<std::string, QHostAddress> _oscHosts; //!< Network hosts of the devices, as resolved.
+    std::map<int, std::string> _hostLookups;       //!< Hosts being looked up, by lookup ID.
+
     //Device _defaultDevice; //!< The default network device used.
 
     bool _recording;    //!< Handling recording state.
     bool _paused;       //!< Handling paused state.
 
+    EngineEventQueue _engineEvents;  //!< Events posted from the Engines execution thread.
+    EngineEventQueue _networkEvents; //!< Events posted from the Engines network thread.
+    QAtomicInt _engineEventsWakeup;  //!< Set while a request to handle posted events is pending.
+    bool _processingEngineEvents;    //!< Handling posted events processing state.
+
+    std::multimap<qint64, EngineEvent> _scheduledCommands; //!< Transport commands waiting for their due time.
+    QBasicTimer _transportTimer;                            //!< Timer waking up before the next scheduled command.
+
+    TimelineIndex _timeline;                    //!< Index of the boxes over time.
+    std::set<unsigned int> _timelineDirtyBoxes; //!< Boxes changed since the last timeline index update.
+    std::set<unsigned int> _mutedStarts;        //!< Boxes whose start messages are muted in the engines.
+    std::set<unsigned int> _mutedEnds;          //!< Boxes whose end messages are muted in the engines.
+    bool _mutingStatesKnown;                    //!< Handles if the muting states of the engines match the muted sets.
+
+    TriggerSchedule _triggerSchedule;           //!< Trigger points sorted by date.
+
+    std::set<unsigned int> _scheduleDirtyBoxes; //!< Boxes changed since the last trigger schedule update.
+    unsigned int _parallelStateThreshold;       //!< Number of boxes above which the scene state is computed in parallel.
+
+    unsigned int _editDepth;                    //!< Number of begun and not committed editions.
+    std::map<unsigned int, Coords> _pendingEdits; //!< Boxes coordinates recorded by the current edition.
+
     QDomDocument *_doc; //!< Handling document used for saving/loading.
 };
 
@@ -0,0 +1,172 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef MESSAGE_VALUE_HPP
+#define MESSAGE_VALUE_HPP
+
+/*!
+ * \file MessageValue.hpp
+ */
+
+#include <QString>
+#include <QStringList>
+#include <string>
+#include <vector>
+
+/*!
+ * \class MessageValue
+ *
+ * \brief Value of a network message, parsed once into typed atoms.
+ *
+ * A value is a list of atoms separated by blanks, each atom being an integer,
+ * a float or a string. Values are compared atom by atom on their types rather
+ * than on their text, so that "1", "1.0" and "1.00" are the same value.
+ * Quotes of a string atom are kept, so that the text of a value is given back
+ * as it was parsed.
+ * Up to INLINE_ATOMS atoms are stored without any allocation.
+ */
+class MessageValue
+{
+  public:
+    //! Type of a value or of one of its atoms.
+    enum Type {
+      NONE,   //!< No atom.
+      INT,    //!< An integer.
+      FLOAT,  //!< A float.
+      STRING, //!< A string.
+      LIST    //!< Several atoms, only used as the type of a whole value.
+    };
+
+    MessageValue();
+
+    /*!
+     * \brief Parses the text of a value.
+     *
+     * \param value : the value, atoms separated by blanks, a quoted atom being one string
+     * \return the parsed value
+     */
+    static MessageValue parse(const QString &value);
+    static MessageValue parse(const std::string &value);
+
+    /*!
+     * \brief Gets the type of the value.
+     *
+     * \return NONE if empty, LIST if several atoms, the type of the atom otherwise
+     */
+    Type type() const;
+
+    /*!
+     * \brief Gets the number of atoms of the value.
+     */
+    inline unsigned int
+    size() const { return _size; }
+
+    /*!
+     * \brief Gets the type of an atom.
+     *
+     * \param index : the index of the atom
+     */
+    Type atomType(unsigned int index) const;
+
+    /*!
+     * \brief Gets an atom as an integer, truncating floats and 0 for strings.
+     *
+     * \param index : the index of the atom
+     */
+    int toInt(unsigned int index) const;
+
+    /*!
+     * \brief Gets an atom as a float, 0 for strings.
+     *
+     * \param index : the index of the atom
+     */
+    float toFloat(unsigned int index) const;
+
+    /*!
+     * \brief Gets the text of an atom, quotes included.
+     *
+     * \param index : the index of the atom
+     */
+    QString toString(unsigned int index) const;
+
+    /*!
+     * \brief Gets the text of an atom without its quotes.
+     *
+     * \param index : the index of the atom
+     */
+    QString toSymbol(unsigned int index) const;
+
+    /*!
+     * \brief Gets the text of the whole value, atoms separated by a blank.
+     */
+    QString toString() const;
+
+    /*!
+     * \brief Compares two values atom by atom. Integers and floats are compared as numbers,
+     * strings on their text, quotes included.
+     */
+    bool operator==(const MessageValue &other) const;
+    inline bool
+    operator!=(const MessageValue &other) const { return !(*this == other); }
+
+    //! Number of atoms stored without allocation.
+    static const unsigned int INLINE_ATOMS = 4;
+
+  private:
+    /*!
+     * \brief Parses atoms from a text in UTF-8.
+     */
+    void parseAtoms(const char *text, int length);
+
+    void append(Type type, int intValue, float floatValue, const QString &stringValue, unsigned char quotes = 0);
+
+    struct Atom {
+      Type type;
+      unsigned char quotes; //!< Number of quotes around a STRING atom in the text, 0 to 2.
+      union {
+        int i;
+        float f;
+        int symbol;     //!< Index of the string in _symbols.
+      };
+    };
+
+    const Atom &atom(unsigned int index) const;
+
+    Atom _inline[INLINE_ATOMS];   //!< First atoms.
+    std::vector<Atom> _overflow;  //!< Atoms after INLINE_ATOMS.
+    unsigned int _size;           //!< Number of atoms.
+    QStringList _symbols;         //!< Strings of the STRING atoms.
+};
+#endif
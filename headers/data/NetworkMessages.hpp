@@ -9,10 +9,13 @@
  */
 
 #include <QMap>
+#include <QHash>
 #include <QObject>
 #include <string>
 #include <QStringList>
 #include <QTreeWidgetItem>
+#include "AddressTable.hpp"
+#include "MessageValue.hpp"
 
 using std::string;
 
@@ -29,13 +32,15 @@ struct Message {
   QString device;   // MinuitDevice
   QString message;  // /gain/
   QString value;
+  MessageValue parsedValue; // value parsed once, for comparisons
+  std::string compiled;     // device/message value, as sent to the engines
 };
 
 struct Data {
   unsigned int sampleRate;
   QString value;
   QString msg;
-  QString address;
+  AddressID address;
   bool hasCurve;
   bool curveActivated;
   bool redundancy;
@@ -44,14 +49,18 @@ struct Data {
 /**!
  * \class NetworkMessages
  *
- * \brief Network messages editor, derived class from Qt's QObject.
+ * \brief Messages of a box extremity, derived class from Qt's QObject.
+ *
+ * Messages are stored by address. Tree items of the NetworkTree are only a view
+ * on them : each message can be linked to the item showing its address, so that
+ * messages can be loaded, compared and played without any tree.
  */
 class NetworkMessages : public QObject {
   Q_OBJECT
 
   public:
     NetworkMessages();
-    NetworkMessages(QMap<QTreeWidgetItem *, Message> *msgs);
+    NetworkMessages(const NetworkMessages *messages);
     ~NetworkMessages();
 
     /*!
@@ -62,15 +71,20 @@ class NetworkMessages : public QObject {
     /*!
      * \brief Fills a list with all messages.
      *
+     * Each message is compiled when it is added or changed, and the list is only
+     * rebuilt after a change.
+     *
      * return a list filled with messages
      */
-    std::vector<std::string> computeMessages();
+    const std::vector<std::string> &computeMessages() const;
 
     /*!
      * \brief Adds a message to send with a specific device.
      *
+     * \param item : the tree item showing the message address, NULL if none
      * \param device : the device to use
-     * \param msg : the message to send
+     * \param message : the address of the message in the device
+     * \param value : the value to send
      */
     void addMessage(QTreeWidgetItem *item, const QString &device, const QString &message, const QString &value);
     void addMessage(QTreeWidgetItem *item, QString address);
@@ -93,42 +107,54 @@ class NetworkMessages : public QObject {
     void setMessages(const QList < QPair<QTreeWidgetItem *, Message> > messagesList);
 
     /*!
-     * \brief Sets the list of messages.
+     * \brief Set the list of messages.
      */
-    inline void
-    setMessages(QMap<QTreeWidgetItem *, Message> *messages)
-    {
-      _messages->clear();
-      _messages = messages;
-      ;
-    }
+    void setMessages(const QMap<QTreeWidgetItem *, Data> messagesList);
 
     /*!
-     * \brief Sets the list of messages just for one device. Filter the list and clear/reset only message starting with deviceName.
+     * \brief Changes the value of the message shown by an item.
+     * \param item : the item (key)
+     * \param newValue : the newValue
      */
-    void setDeviceMessages(QString deviceName, QMap<QTreeWidgetItem *, Message> *messages);
+    bool setValue(QTreeWidgetItem *item, QString newValue);
 
     /*!
-     * \brief Set the list of messages.
+     * \brief Gets the messages by address.
      */
-    void setMessages(const QMap<QTreeWidgetItem *, Data> messagesList);
+    inline const QMap<AddressID, Message> &
+    table() const { return _messages; }
 
     /*!
-     * \brief Changes the start value of an item of the map.
-     * \param item : the item (key)
-     * \param msg : the newValue
+     * \brief Determines if an item shows one of the messages.
      */
-    bool setValue(QTreeWidgetItem *item, QString newValue);
+    inline bool
+    contains(QTreeWidgetItem *item) const { return _itemAddresses.contains(item); }
 
-    QMap<QTreeWidgetItem *, Message> *getMessages();
+    /*!
+     * \brief Gets the message shown by an item.
+     * \return the message, empty if the item shows no message
+     */
+    Message message(QTreeWidgetItem *item) const;
 
-    inline QList<QTreeWidgetItem *> getItems(){ return _messages->keys(); }
+    /*!
+     * \brief Gets the item showing an address.
+     * \return the item, NULL if none
+     */
+    inline QTreeWidgetItem *
+    item(AddressID address) const { return _addressItems.value(address, NULL); }
+
+    inline QList<QTreeWidgetItem *> getItems(){ return _itemAddresses.keys(); }
     std::string computeMessage(const Message &msg);
     std::string computeMessageWithoutValue(const Message &msg);
-    inline QList<Message> messages(){ return _messages->values(); }
+    inline QList<Message> messages(){ return _messages.values(); }
     QMap<QString, QString> toMapAddressValue();
+
+    /*!
+     * \brief Gets the values of the messages by address.
+     */
+    QMap<AddressID, QString> values() const;
     inline bool
-    isEmpty(){ return _messages->isEmpty(); }
+    isEmpty(){ return _messages.isEmpty(); }
 
   public slots:
     void removeMessage(QTreeWidgetItem *item);
@@ -140,17 +166,34 @@ class NetworkMessages : public QObject {
     void clearDevicesMsgs(QList<QString> devices);
 
   signals:
-    void messageChanged(const std::string &address);
-    void messageRemoved(const std::string &address);
+    void messageChanged(AddressID address);
+    void messageRemoved(AddressID address);
     void messagesChanged();
 
   private:
     bool messageToString(const Message &msg, string &device, string &message, string &value);
 
-    QMap<QTreeWidgetItem *, Message> *_messages; //!<Messages list.
+    /*!
+     * \brief Removes the message of an address, and its link to its item.
+     */
+    void removeAddress(AddressID address);
+
+    /*!
+     * \brief Links an item to the address it shows, unlinking it from its previous address.
+     */
+    void link(QTreeWidgetItem *item, AddressID address);
+
+    /*!
+     * \brief Compiles a message and marks the list of messages as outdated.
+     */
+    void compile(Message &msg);
+
+    QMap<AddressID, Message> _messages;                //!< Messages by address.
+    QHash<QTreeWidgetItem *, AddressID> _itemAddresses; //!< Address shown by each item.
+    QHash<AddressID, QTreeWidgetItem *> _addressItems;  //!< Item showing each address.
+    mutable std::vector<std::string> _compiled;         //!< Compiled messages, in address order.
+    mutable bool _compiledValid;                        //!< If _compiled is up to date.
 
   protected:
 };
 #endif // NETWORKMESSAGES_HPP
-
-
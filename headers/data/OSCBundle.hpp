@@ -0,0 +1,118 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef OSC_BUNDLE_HPP
+#define OSC_BUNDLE_HPP
+
+/*!
+ * \file OSCBundle.hpp
+ */
+
+#include <QByteArray>
+#include <QtGlobal>
+#include <string>
+
+/*!
+ * \class OSCBundle
+ *
+ * \brief OSC bundle encoder, grouping messages sent in a single datagram.
+ *
+ * Arguments are given as a space separated string, each argument being encoded
+ * as an int, a float or a string depending on its text.
+ */
+class OSCBundle
+{
+  public:
+    /*!
+     * \brief Creates an empty bundle.
+     *
+     * \param seconds : the seconds of the bundle NTP timetag
+     * \param fraction : the fraction of second of the bundle NTP timetag
+     */
+    OSCBundle(quint32 seconds = 0, quint32 fraction = IMMEDIATELY);
+
+    /*!
+     * \brief Adds a message to the bundle, unless the bundle would exceed its maximum size.
+     * A message is always added to an empty bundle.
+     *
+     * \param address : the OSC address of the message
+     * \param arguments : the space separated arguments of the message
+     * \return false if the bundle is full
+     */
+    bool addMessage(const std::string &address, const std::string &arguments);
+
+    /*!
+     * \brief Removes every message from the bundle.
+     */
+    void clear();
+
+    /*!
+     * \brief Gets the number of messages of the bundle.
+     *
+     * \return the number of messages
+     */
+    inline unsigned int
+    size() const { return _size; }
+
+    /*!
+     * \brief Gets the encoded bundle.
+     *
+     * \return the bundle datagram
+     */
+    inline const QByteArray &
+    data() const { return _data; }
+
+    /*!
+     * \brief Encodes a single OSC message.
+     *
+     * \param address : the OSC address of the message
+     * \param arguments : the space separated arguments of the message
+     * \return the encoded message
+     */
+    static QByteArray encodeMessage(const std::string &address, const std::string &arguments);
+
+    //! Timetag fraction meaning the bundle has to be handled immediately.
+    static const quint32 IMMEDIATELY = 1;
+
+    //! Maximum size of a bundle in bytes, safe for common OSC receivers buffers.
+    static const int MAX_SIZE = 8192;
+
+  private:
+    QByteArray _data;   //!< The encoded bundle.
+    unsigned int _size; //!< The number of messages.
+    quint32 _seconds;   //!< The seconds of the timetag.
+    quint32 _fraction;  //!< The fraction of the timetag.
+};
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef RELATION_INDEX_HPP
+#define RELATION_INDEX_HPP
+
+/*!
+ * \file RelationIndex.hpp
+ */
+
+#include <vector>
+#include "BoxExtremity.hpp"
+#include "EntityStore.hpp"
+
+/*!
+ * \brief Structure containing the boxes extremities linked by a relation.
+ */
+struct RelationEnds {
+  unsigned int firstBox;        //!< The first box of the relation.
+  BoxExtremity firstExtremity;  //!< The extremity of the first box.
+  unsigned int secondBox;       //!< The second box of the relation.
+  BoxExtremity secondExtremity; //!< The extremity of the second box.
+};
+
+/*!
+ * \class RelationIndex
+ *
+ * \brief Temporal relations of a composition indexed by the boxes they link.
+ *
+ * Each box keeps the relations attached to its extremities, so that the
+ * relations of a box are found without asking Engines about every relation.
+ */
+class RelationIndex
+{
+  public:
+    /*!
+     * \brief Removes every relation from the index.
+     */
+    void clear();
+
+    /*!
+     * \brief Adds a relation to the index.
+     *
+     * \param relID : the relation
+     * \param ends : the boxes extremities linked by the relation
+     */
+    void addRelation(unsigned int relID, const RelationEnds &ends);
+
+    /*!
+     * \brief Removes a relation from the index.
+     *
+     * \param relID : the relation to remove
+     */
+    void removeRelation(unsigned int relID);
+
+    /*!
+     * \brief Determines if a relation is indexed.
+     *
+     * \param relID : the relation
+     * \return true if the relation is indexed
+     */
+    bool contains(unsigned int relID) const;
+
+    /*!
+     * \brief Gets the relations attached to a box.
+     *
+     * \param boxID : the box
+     * \param relations : the vector to be filled with relation IDs
+     */
+    void boxRelations(unsigned int boxID, std::vector<unsigned int> &relations) const;
+
+    /*!
+     * \brief Gets the relations attached to an extremity of a box.
+     *
+     * \param boxID : the box
+     * \param extremity : the extremity of the box
+     * \param relations : the vector to be filled with relation IDs
+     */
+    void boxRelations(unsigned int boxID, BoxExtremity extremity, std::vector<unsigned int> &relations) const;
+
+    /*!
+     * \brief Determines if two boxes are linked by a relation.
+     *
+     * \param ID1 : the first box
+     * \param ID2 : the second box
+     * \return true if a relation links both boxes
+     */
+    bool areRelated(unsigned int ID1, unsigned int ID2) const;
+
+  private:
+    /*!
+     * \brief Structure containing a relation attached to a box.
+     */
+    struct Attachment {
+      unsigned int relID;     //!< The relation.
+      BoxExtremity extremity; //!< The extremity of the box the relation is attached to.
+    };
+
+    void attach(unsigned int boxID, unsigned int relID, BoxExtremity extremity);
+    void detach(unsigned int boxID, unsigned int relID);
+
+    EntityStore<RelationEnds> _relations;                     //!< Boxes extremities linked by each relation.
+    EntityStore<std::vector<Attachment> > _attachments;       //!< Relations attached to each box.
+};
+#endif
@@ -0,0 +1,151 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef SCORE_FILE_HPP
+#define SCORE_FILE_HPP
+
+/*!
+ * \file ScoreFile.hpp
+ */
+
+#include <QString>
+#include <QStringList>
+#include <QPointF>
+#include <QColor>
+#include <vector>
+
+class QIODevice;
+
+/*!
+ * \class ScoreFile
+ *
+ * \brief Graphical part of a composition as stored in a file.
+ *
+ * The temporal part of a composition (boxes dates, relations, trigger points,
+ * messages and curves) is stored by the Engines in a ".simone" file beside it.
+ * A score file holds what the Engines do not store : the view, the graphical
+ * attributes of the boxes, the network devices and the OSC messages, as XML.
+ *
+ * Files are always written beside their destination, synced to the disk, then
+ * renamed over it.
+ */
+class ScoreFile
+{
+  public:
+    //! Result of a reading.
+    enum Status {
+      READ_OK,       //!< The score was read.
+      NOT_A_SCORE,   //!< The file is an XML document of the old format.
+      OPEN_ERROR,    //!< The file can not be opened.
+      FORMAT_ERROR,  //!< The file is not well formed.
+      INVALID_ROOT   //!< The root element is not the expected one.
+    };
+
+    //! State of an optional part of a score.
+    enum PartState {
+      PART_ABSENT,    //!< The part is not in the file.
+      PART_MISPLACED, //!< An other element is found where the part is expected.
+      PART_PRESENT    //!< The part was read.
+    };
+
+    /*!
+     * \brief Structure containing the graphical attributes of a box.
+     */
+    struct Box {
+      int ID;                //!< The ID of the box.
+      QString type;          //!< The type of the box, "parent" being the only one handled.
+      QString name;          //!< The name of the box.
+      int mother;            //!< The ID of the mother box.
+      unsigned int begin;    //!< The begin date in ms.
+      unsigned int duration; //!< The duration in ms.
+      unsigned int topLeftY; //!< The vertical position.
+      unsigned int sizeY;    //!< The height.
+      QColor color;          //!< The color.
+    };
+
+    /*!
+     * \brief Structure containing a network device.
+     */
+    struct Device {
+      QString name;   //!< The name of the device.
+      QString ip;     //!< The network host.
+      QString port;   //!< The network port.
+      QString plugin; //!< The plug-in used.
+    };
+
+    ScoreFile();
+
+    /*!
+     * \brief Reads a score from a file.
+     *
+     * \param fileName : the file to read
+     * \param expectedBoxes : number of boxes expected, used to size the boxes list
+     * \return the status of the reading, errorString() telling more on errors
+     */
+    Status read(const QString &fileName, unsigned int expectedBoxes = 0);
+
+    /*!
+     * \brief Writes the score into a file.
+     *
+     * The Engines part of the score, when given, is renamed to fileName + ".simone"
+     * only once the score is written, and removed on failure.
+     *
+     * \param fileName : the file to write
+     * \param enginesTempName : the ".simone" file already written beside, empty if none
+     * \return false on error, errorString() telling more
+     */
+    bool write(const QString &fileName, const QString &enginesTempName = QString());
+
+    /*!
+     * \brief Gets the reason of the last failure.
+     */
+    inline const QString &
+    errorString() const { return _error; }
+
+    float zoom;                 //!< Zoom of the view.
+    QPointF center;             //!< Center of the view.
+    std::vector<Box> boxes;     //!< Boxes, in the order of the file.
+    std::vector<Device> devices; //!< Network devices.
+    QStringList OSCMessages;    //!< OSC messages of the network tree.
+    PartState devicesState;     //!< State of the devices part.
+    PartState OSCMessagesState; //!< State of the OSC messages part.
+
+  private:
+    Status readXml(QIODevice &device, unsigned int expectedBoxes);
+    bool writeXml(QIODevice &device);
+
+    QString _error; //!< Reason of the last failure.
+};
+#endif
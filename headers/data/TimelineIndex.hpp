@@ -0,0 +1,269 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef TIMELINE_INDEX_HPP
+#define TIMELINE_INDEX_HPP
+
+/*!
+ * \file TimelineIndex.hpp
+ */
+
+#include <QString>
+#include "AddressTable.hpp"
+#include <QMap>
+#include <QHash>
+#include <vector>
+#include <map>
+
+/*!
+ * \brief Structure containing a value written on an address by a box extremity.
+ */
+struct TimelineWrite {
+  unsigned int date;  //!< The date of the write in ms.
+  unsigned int boxID; //!< The box writing.
+  bool end;           //!< Handles if the write is done by the end of the box.
+  QString value;      //!< The value written.
+};
+
+/*!
+ * \class TimelineIndex
+ *
+ * \brief Index of the boxes of a composition over time.
+ *
+ * Boxes are kept in an interval tree over [begin, end] to find the boxes playing at
+ * a given date, and every address keeps the writes done by start and end messages
+ * sorted by date, to find the value of the address at a given date.
+ * Box updates are incremental, the interval tree is rebuilt lazily before queries.
+ *
+ * The whole state is also checkpointed at regular dates, so that the state at a date
+ * is computed by replaying the writes done since the previous checkpoint only.
+ * Checkpoints following a box change are dropped, and rebuilt lazily on the next query.
+ */
+class TimelineIndex
+{
+  public:
+    TimelineIndex(unsigned int checkpointInterval = DEFAULT_CHECKPOINT_INTERVAL);
+
+    /*!
+     * \brief Removes every box from the index.
+     */
+    void clear();
+
+    /*!
+     * \brief Adds or updates a box.
+     *
+     * \param boxID : the box to add or update
+     * \param begin : the begin date of the box in ms
+     * \param end : the end date of the box in ms
+     * \param startMessages : the values written by the start of the box, by address ID
+     * \param endMessages : the values written by the end of the box, by address ID
+     */
+    void setBox(unsigned int boxID, unsigned int begin, unsigned int end,
+                const QMap<AddressID, QString> &startMessages, const QMap<AddressID, QString> &endMessages);
+
+    /*!
+     * \brief Removes a box.
+     *
+     * \param boxID : the box to remove
+     */
+    void removeBox(unsigned int boxID);
+
+    /*!
+     * \brief Gets the number of boxes indexed.
+     *
+     * \return the number of boxes
+     */
+    inline unsigned int
+    size() const { return _boxes.size(); }
+
+    /*!
+     * \brief Gets the boxes playing at a date, i.e. begun strictly before and ending strictly after.
+     *
+     * \param date : the date in ms
+     * \param boxes : the vector to be filled with box IDs
+     */
+    void boxesPlayingAt(unsigned int date, std::vector<unsigned int> &boxes);
+
+    /*!
+     * \brief Gets the boxes beginning strictly before a date.
+     *
+     * \param date : the date in ms
+     * \param boxes : the vector to be filled with box IDs
+     */
+    void boxesBegunBefore(unsigned int date, std::vector<unsigned int> &boxes);
+
+    /*!
+     * \brief Gets the boxes ending strictly before a date.
+     *
+     * \param date : the date in ms
+     * \param boxes : the vector to be filled with box IDs
+     */
+    void boxesEndedBefore(unsigned int date, std::vector<unsigned int> &boxes);
+
+    /*!
+     * \brief Gets the state of every address at a date.
+     * The last write done at or before the date is kept. On a date tie, the box with
+     * the lowest ID wins, and the end of a box wins over its start.
+     * The end of a box beginning at the date is not taken into account.
+     *
+     * \param date : the date in ms
+     * \param state : the map to be filled with the last write by address ID
+     */
+    void stateAt(unsigned int date, QMap<AddressID, TimelineWrite> &state);
+
+    /*!
+     * \brief Sets the interval between two checkpoints.
+     *
+     * \param interval : the interval in ms, 0 to disable checkpoints
+     */
+    void setCheckpointInterval(unsigned int interval);
+
+    /*!
+     * \brief Gets the interval between two checkpoints.
+     *
+     * \return the interval in ms, 0 if checkpoints are disabled
+     */
+    inline unsigned int
+    checkpointInterval() const { return _checkpointInterval; }
+
+    /*!
+     * \brief Gets the number of checkpoints currently built.
+     *
+     * \return the number of checkpoints
+     */
+    inline unsigned int
+    checkpointsCount() const { return _checkpoints.size(); }
+
+    /*!
+     * \brief Gets an estimation of the memory used by the checkpoints currently built.
+     *
+     * \return the memory used in bytes
+     */
+    unsigned int checkpointsMemory() const;
+
+    /*!
+     * \brief Orders writes by date. On a date tie, the write winning comes last.
+     *
+     * \param write1 : the first write
+     * \param write2 : the second write
+     * \return true if the first write is overridden by the second one
+     */
+    static bool writeBefore(const TimelineWrite &write1, const TimelineWrite &write2);
+
+    //! Default interval between two checkpoints in ms.
+    static const unsigned int DEFAULT_CHECKPOINT_INTERVAL = 10000;
+
+  private:
+    /*!
+     * \brief Structure containing the span of a box.
+     */
+    struct Interval {
+      unsigned int boxID;
+      unsigned int begin;
+      unsigned int end;
+    };
+
+    /*!
+     * \brief Structure identifying a write in the chronology of the composition.
+     */
+    struct ChronologyKey {
+      unsigned int date;
+      unsigned int boxID;
+      bool end;
+      AddressID address;
+
+      /*!
+       * \brief Orders writes by date. On a date tie, the write winning comes last.
+       */
+      bool operator<(const ChronologyKey &other) const;
+    };
+
+    /*!
+     * \brief Structure containing the indexed data of a box.
+     */
+    struct BoxRecord {
+      unsigned int begin;
+      unsigned int end;
+      std::vector<AddressID> addresses; //!< Addresses written by the box.
+    };
+
+    /*!
+     * \brief Rebuilds the interval tree if boxes changed since the last query.
+     */
+    void rebuildIntervals();
+
+    /*!
+     * \brief Computes the maximal end of each subtree of the implicit interval tree.
+     */
+    unsigned int buildMaxEnds(unsigned int first, unsigned int last);
+
+    /*!
+     * \brief Collects the intervals containing a date in a subtree of the interval tree.
+     */
+    void stab(unsigned int first, unsigned int last, unsigned int date, std::vector<unsigned int> &boxes) const;
+
+    /*!
+     * \brief Inserts a write in the writes of an address, keeping them sorted.
+     */
+    void insertWrite(AddressID address, const TimelineWrite &write);
+
+    /*!
+     * \brief Drops the checkpoints taken at or after a date.
+     */
+    void invalidateCheckpoints(unsigned int date);
+
+    /*!
+     * \brief Builds the missing checkpoints up to a checkpoint index.
+     */
+    void buildCheckpoints(unsigned int index);
+
+    /*!
+     * \brief Applies to a state the writes done after a date, up to another date.
+     */
+    void replay(unsigned int from, unsigned int to, QMap<AddressID, TimelineWrite> &state, bool skipUnreachedEnds) const;
+
+    std::map<unsigned int, BoxRecord> _boxes;                 //!< Indexed boxes by ID.
+    QHash<AddressID, std::vector<TimelineWrite> > _writes;    //!< Writes by address, sorted by date.
+    std::vector<Interval> _intervals;                         //!< Boxes spans sorted by begin date.
+    std::vector<unsigned int> _maxEnds;                       //!< Maximal end of each interval tree subtree.
+    std::vector<std::pair<unsigned int, unsigned int> > _ends; //!< Boxes (end date, ID) sorted by end date.
+    bool _intervalsDirty;                                     //!< Handles if the interval tree needs a rebuild.
+
+    std::map<ChronologyKey, QString> _chronology;                 //!< Every write, in the order they are done.
+    unsigned int _checkpointInterval;                             //!< Interval between two checkpoints in ms.
+    std::vector<QMap<AddressID, TimelineWrite> > _checkpoints;      //!< States at each multiple of the interval.
+    std::vector<unsigned int> _checkpointsMemory;                 //!< Memory used by each checkpoint in bytes.
+};
+#endif
@@ -0,0 +1,117 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+#ifndef TRIGGER_SCHEDULE_HPP
+#define TRIGGER_SCHEDULE_HPP
+
+/*!
+ * \file TriggerSchedule.hpp
+ */
+
+#include <map>
+#include <set>
+#include <vector>
+#include <utility>
+
+/*!
+ * \class TriggerSchedule
+ *
+ * \brief Trigger points of a composition sorted by date.
+ *
+ * Each trigger point is kept with the box it belongs to, so that the trigger
+ * points of a moved box can be rescheduled.
+ */
+class TriggerSchedule
+{
+  public:
+    /*!
+     * \brief Removes every trigger point from the schedule.
+     */
+    void clear();
+
+    /*!
+     * \brief Adds a trigger point or moves it to a new date.
+     *
+     * \param trgID : the trigger point
+     * \param boxID : the box the trigger point belongs to
+     * \param date : the date of the trigger point in ms
+     */
+    void setTrigger(unsigned int trgID, unsigned int boxID, unsigned int date);
+
+    /*!
+     * \brief Removes a trigger point.
+     *
+     * \param trgID : the trigger point to remove
+     */
+    void removeTrigger(unsigned int trgID);
+
+    /*!
+     * \brief Determines if a trigger point is scheduled.
+     *
+     * \param trgID : the trigger point
+     * \return true if the trigger point is scheduled
+     */
+    bool contains(unsigned int trgID) const;
+
+    /*!
+     * \brief Gets the date of a trigger point.
+     *
+     * \param trgID : the trigger point
+     * \return the date of the trigger point in ms, 0 if not scheduled
+     */
+    unsigned int date(unsigned int trgID) const;
+
+    /*!
+     * \brief Gets the trigger points of a box.
+     *
+     * \param boxID : the box
+     * \param triggers : the vector to be filled with trigger point IDs
+     */
+    void boxTriggers(unsigned int boxID, std::vector<unsigned int> &triggers) const;
+
+    /*!
+     * \brief Gets the trigger points strictly after a date, sorted by date.
+     *
+     * \param date : the date in ms
+     * \param triggers : the vector to be filled with trigger point IDs
+     */
+    void triggersAfter(unsigned int date, std::vector<unsigned int> &triggers) const;
+
+  private:
+    std::set<std::pair<unsigned int, unsigned int> > _schedule;              //!< Trigger points by (date, ID).
+    std::map<unsigned int, std::pair<unsigned int, unsigned int> > _triggers; //!< Box and date by trigger point.
+    std::multimap<unsigned int, unsigned int> _boxTriggers;                   //!< Trigger points by box.
+};
+#endif
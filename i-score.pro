@@ -70,7 +70,17 @@ headers/data/AbstractCurve.hpp \
 headers/data/AbstractRelation.hpp \
 headers/data/AbstractParentBox.hpp \
 headers/data/AbstractTriggerPoint.hpp \
+headers/data/AddressTable.hpp \
+headers/data/BoxExtremity.hpp \
+headers/data/EngineEventQueue.hpp \
+headers/data/EntityStore.hpp \
 headers/data/Maquette.hpp \
+headers/data/MessageValue.hpp \
+headers/data/OSCBundle.hpp \
+headers/data/RelationIndex.hpp \
+headers/data/ScoreFile.hpp \
+headers/data/TimelineIndex.hpp \
+headers/data/TriggerSchedule.hpp \
 headers/GUI/AttributesEditor.hpp \
 headers/GUI/BasicBox.hpp \
 headers/GUI/BoxContextMenu.hpp \
@@ -89,7 +99,7 @@ headers/GUI/NetworkMessagesEditor.hpp \
 headers/GUI/NetworkTree.hpp \
 headers/GUI/ParentBox.hpp \
 headers/GUI/ParentBoxContextMenu.hpp \
-headers/GUI/PlayingThread.hpp \
+headers/GUI/PlaybackClock.hpp \
 headers/GUI/Relation.hpp \
 headers/GUI/RelationEdit.hpp \
 headers/GUI/TextEdit.hpp \
@@ -112,7 +122,15 @@ src/data/AbstractCurve.cpp \
 src/data/AbstractParentBox.cpp \
 src/data/AbstractRelation.cpp \
 src/data/AbstractTriggerPoint.cpp \
+src/data/AddressTable.cpp \
+src/data/EngineEventQueue.cpp \
 src/data/Maquette.cpp \
+src/data/MessageValue.cpp \
+src/data/OSCBundle.cpp \
+src/data/RelationIndex.cpp \
+src/data/ScoreFile.cpp \
+src/data/TimelineIndex.cpp \
+src/data/TriggerSchedule.cpp \
 src/GUI/AttributesEditor.cpp \
 src/GUI/BasicBox.cpp \
 src/GUI/BoxContextMenu.cpp \
@@ -131,7 +149,7 @@ src/GUI/NetworkMessagesEditor.cpp \
 src/GUI/NetworkTree.cpp \
 src/GUI/ParentBox.cpp \
 src/GUI/ParentBoxContextMenu.cpp \
-src/GUI/PlayingThread.cpp \
+src/GUI/PlaybackClock.cpp \
 src/GUI/Relation.cpp \
 src/GUI/RelationEdit.cpp \
 src/GUI/TextEdit.cpp \
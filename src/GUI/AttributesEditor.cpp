@@ -476,8 +476,8 @@ AttributesEditor::deployMessageChanged(QTreeWidgetItem *item, QString newName)
   if (_scene->paused()) {
       _scene->stopWithGoto();
     }
-  std::map<unsigned int, BasicBox *>::iterator it;
-  std::map<unsigned int, BasicBox *> boxesMap = Maquette::getInstance()->getBoxes();
+  EntityStore<BasicBox*>::const_iterator it;
+  const EntityStore<BasicBox*> &boxesMap = Maquette::getInstance()->getBoxes();
   unsigned int boxID;
 
   for (it = boxesMap.begin(); it != boxesMap.end(); it++) {
@@ -506,8 +506,8 @@ AttributesEditor::deployDeviceChanged(QString oldName, QString newName)
       _scene->stopWithGoto();
     }
 
-  std::map<unsigned int, BasicBox *>::iterator it;
-  std::map<unsigned int, BasicBox *> boxesMap = Maquette::getInstance()->getBoxes();
+  EntityStore<BasicBox*>::const_iterator it;
+  const EntityStore<BasicBox*> &boxesMap = Maquette::getInstance()->getBoxes();
 
   unsigned int boxID;
 
@@ -102,6 +102,17 @@ BasicBox::BasicBox(const QPointF &press, const QPointF &release, MaquetteScene *
   _endMenu = NULL;
   _startMenuButton = NULL;
   _endMenuButton = NULL;
+  _startMenuProxy = NULL;
+  _endMenuProxy = NULL;
+  _jumpToStartCue = NULL;
+  _jumpToEndCue = NULL;
+  _updateStartCue = NULL;
+  _updateEndCue = NULL;
+  _boxContentWidget = NULL;
+  _boxWidget = NULL;
+  _comboBox = NULL;
+  _curveProxy = NULL;
+  _comboBoxProxy = NULL;
 
 
   /// \todo : !! Problème d'arrondi, on cast en int des floats !! A étudier parce que crash (avec 0 notamment) si on remet en float. NH
@@ -120,17 +131,90 @@ BasicBox::BasicBox(const QPointF &press, const QPointF &release, MaquetteScene *
 
   init();
 
+  // In lazy mode, widgets are built when the box is first shown or selected
+  if (!_scene->lazyContents()) {
+      createContents();
+    }
+
+  update();
+}
+
+void
+BasicBox::createContents()
+{
   createWidget();
   createActions();
   createMenus();
 
-  update();
   connect(_comboBox, SIGNAL(currentIndexChanged(const QString &)), _boxContentWidget, SLOT(updateDisplay(const QString &)));
 }
 
+void
+BasicBox::materializeContents()
+{
+  if (hasContents()) {
+      return;
+    }
+
+  createContents();
+  centerWidget();
+  if (ID() != NO_ID) {
+      _boxContentWidget->updateMessages(ID(), true);
+      _scene->touchBoxContents(ID());
+    }
+  update();
+}
+
+void
+BasicBox::releaseContents()
+{
+  if (!hasContents()) {
+      return;
+    }
+
+  // Proxies delete the widgets they hold, the menus being children of the curve widget
+  delete _curveProxy;
+  delete _comboBoxProxy;
+  delete _startMenuProxy;
+  delete _endMenuProxy;
+  delete _jumpToStartCue;
+  delete _jumpToEndCue;
+  delete _updateStartCue;
+  delete _updateEndCue;
+
+  _startMenu = NULL;
+  _endMenu = NULL;
+  _startMenuButton = NULL;
+  _endMenuButton = NULL;
+  _startMenuProxy = NULL;
+  _endMenuProxy = NULL;
+  _jumpToStartCue = NULL;
+  _jumpToEndCue = NULL;
+  _updateStartCue = NULL;
+  _updateEndCue = NULL;
+  _boxContentWidget = NULL;
+  _boxWidget = NULL;
+  _comboBox = NULL;
+  _curveProxy = NULL;
+  _comboBoxProxy = NULL;
+
+  update();
+}
+
+BoxWidget *
+BasicBox::boxContentWidget()
+{
+  materializeContents();
+  return _boxContentWidget;
+}
+
 void
 BasicBox::centerWidget()
 {
+  if (!hasContents()) {
+      return;
+    }
+
   _boxWidget->move(-(width()) / 2 + LINE_WIDTH, -(height()) / 2 + (1.2 * RESIZE_TOLERANCE));
   _boxWidget->resize(width() - 2 * LINE_WIDTH, height() - 1.5 * RESIZE_TOLERANCE);
 
@@ -199,10 +283,10 @@ BasicBox::createMenus()
     );
   _boxContentWidget->setEndMenu(_endMenu);
 
-  QGraphicsProxyWidget *startMenuProxy = new QGraphicsProxyWidget(this);
-  startMenuProxy->setWidget(_startMenuButton);
-  QGraphicsProxyWidget *endMenuProxy = new QGraphicsProxyWidget(this);
-  endMenuProxy->setWidget(_endMenuButton);
+  _startMenuProxy = new QGraphicsProxyWidget(this);
+  _startMenuProxy->setWidget(_startMenuButton);
+  _endMenuProxy = new QGraphicsProxyWidget(this);
+  _endMenuProxy->setWidget(_endMenuButton);
 
   connect(_startMenuButton, SIGNAL(clicked()), _boxContentWidget, SLOT(execStartAction()));
   connect(_endMenuButton, SIGNAL(clicked()), _boxContentWidget, SLOT(execEndAction()));
@@ -273,6 +357,21 @@ BasicBox::BasicBox(AbstractBox *abstract, MaquetteScene *parent)
   : QGraphicsItem()
 {
   _scene = parent;
+  _startMenu = NULL;
+  _endMenu = NULL;
+  _startMenuButton = NULL;
+  _endMenuButton = NULL;
+  _startMenuProxy = NULL;
+  _endMenuProxy = NULL;
+  _jumpToStartCue = NULL;
+  _jumpToEndCue = NULL;
+  _updateStartCue = NULL;
+  _updateEndCue = NULL;
+  _boxContentWidget = NULL;
+  _boxWidget = NULL;
+  _comboBox = NULL;
+  _curveProxy = NULL;
+  _comboBoxProxy = NULL;
 
   _abstract = new AbstractBox(*abstract); /// \todo Pourquoi recevoir un argument *abstract et le ré-instancier ????
 
@@ -293,6 +392,9 @@ BasicBox::~BasicBox()
 QString
 BasicBox::currentText()
 {
+  if (_comboBox == NULL) {
+      return QString();
+    }
   return _comboBox->currentText();
 }
 
@@ -309,6 +411,7 @@ BasicBox::init()
   _hasContextMenu = false;
   _shift = false;
   _playing = false;
+  _progressPosX = 0.;
   _low = false;
   _triggerPoints = new QMap<BoxExtremity, TriggerPoint*>();
   _comment = NULL;
@@ -341,20 +444,26 @@ BasicBox::changeColor(QColor color)
 void
 BasicBox::addToComboBox(QString address)
 {
-  _boxContentWidget->addToComboBox(address);
+  if (hasContents()) {
+      _boxContentWidget->addToComboBox(address);
+    }
 }
 
 void
 BasicBox::updateCurves()
 {
-  _boxContentWidget->updateMessages(_abstract->ID(), true);
+  if (hasContents()) {
+      _boxContentWidget->updateMessages(_abstract->ID(), true);
+    }
   update();
 }
 
 void
 BasicBox::updateCurve(string address, bool forceUpdate)
 {
-  _boxContentWidget->updateCurve(address, forceUpdate);
+  if (hasContents()) {
+      _boxContentWidget->updateCurve(address, forceUpdate);
+    }
   update();
 }
 
@@ -474,6 +583,8 @@ BasicBox::setRelativeTopLeft(const QPointF & rTopLeft)
 void
 BasicBox::setSize(const QPointF & size)
 {
+  // Keeps the scene index up to date
+  prepareGeometryChange();
   _abstract->setWidth(std::max((float)size.x(), MaquetteScene::MS_PRECISION / MaquetteScene::MS_PER_PIXEL));
   _abstract->setHeight(size.y());
 //  std::cout<<"setSize ------> "<< _abstract->ID()<<" "<<_abstract->width()*MaquetteScene::MS_PER_PIXEL<<std::endl;
@@ -578,6 +689,7 @@ BasicBox::resizeWidthEdition(float width)
             }
         }
     }  
+  prepareGeometryChange();
   _abstract->setWidth(newWidth);
   if (_scene->resizeMode() == HORIZONTAL_RESIZE || _scene->resizeMode() == DIAGONAL_RESIZE)
       displayBoxDuration();
@@ -587,6 +699,7 @@ BasicBox::resizeWidthEdition(float width)
 void
 BasicBox::resizeHeightEdition(float height)
 {
+  prepareGeometryChange();
   _abstract->setHeight(height);
 
   if (_comment != NULL) {
@@ -777,11 +890,33 @@ BasicBox::playing() const
   return _playing;
 }
 
+QRectF
+BasicBox::updateProgress()
+{
+  const float progressPosX = _scene->getProgression(_abstract->ID()) * (_abstract->width());
+  if ((int)progressPosX == (int)_progressPosX) {
+      return QRectF();
+    }
+
+  // Strip between both band positions, padded by the pen width
+  const qreal PEN_PADDING = 3.;
+  qreal left = std::min(progressPosX, _progressPosX) - PEN_PADDING;
+  qreal right = std::max(progressPosX, _progressPosX) + PEN_PADDING;
+  QRectF dirty(left, RESIZE_TOLERANCE - PEN_PADDING, right - left, _abstract->height() - RESIZE_TOLERANCE + 2 * PEN_PADDING);
+  dirty.translate(_boxRect.topLeft());
+
+  _progressPosX = progressPosX;
+  update(dirty);
+
+  return mapRectToScene(dirty);
+}
+
 void
 BasicBox::setCrossedExtremity(BoxExtremity extremity)
 {
   if (extremity == BOX_START) {
       _playing = true;
+      _progressPosX = 0.;
     }
   else if (extremity == BOX_END) {
       _playing = false;
@@ -999,23 +1134,23 @@ BasicBox::setEndMessage(QTreeWidgetItem *item, QString address)
 {
   _abstract->setEndMessage(item, address);
 }
-vector<string>
+const vector<string> &
 BasicBox::firstMessagesToSend() const
 {
   return _abstract->firstMsgs();
 }
 
-vector<string>
+const vector<string> &
 BasicBox::lastMessagesToSend() const
 {
   return _abstract->lastMsgs();
 }
 
 AbstractCurve *
-BasicBox::getCurve(const std::string &address)
+BasicBox::getCurve(AddressID address)
 {
   AbstractCurve * curve = NULL;
-  map<string, AbstractCurve*>::iterator it;
+  map<AddressID, AbstractCurve*>::iterator it;
   if ((it = _abstractCurves.find(address)) != _abstractCurves.end()) {
       curve = it->second;
     }
@@ -1026,19 +1161,20 @@ BasicBox::getCurve(const std::string &address)
 void
 BasicBox::curveActivationChanged(string address, bool activated)
 {
-  if (!hasCurve(address)) {
-      addCurve(address);
+  AddressID addressID = AddressTable::intern(address);
+  if (!hasCurve(addressID)) {
+      addCurve(addressID);
     }
 
-  _boxContentWidget->curveActivationChanged(QString::fromStdString(address), activated);
+  boxContentWidget()->curveActivationChanged(QString::fromStdString(address), activated);
 
   if (!activated) {
-      removeCurve(address);
+      removeCurve(addressID);
     }
 }
 
 void
-BasicBox::setCurve(const string &address, AbstractCurve *curve)
+BasicBox::setCurve(AddressID address, AbstractCurve *curve)
 {
   if (curve != NULL) {
       _abstractCurves[address] = curve;
@@ -1049,15 +1185,15 @@ BasicBox::setCurve(const string &address, AbstractCurve *curve)
 }
 
 void
-BasicBox::addCurve(const std::string &address)
+BasicBox::addCurve(AddressID address)
 {
   if (!_curvesAddresses.contains(address)) {
-      Maquette::getInstance()->addCurve(ID(), address);
+      Maquette::getInstance()->addCurve(ID(), AddressTable::stdAddress(address));
       _curvesAddresses << address;
     }
 }
 void
-BasicBox::addCurveAddress(const std::string &address)
+BasicBox::addCurveAddress(AddressID address)
 {
   if (!_curvesAddresses.contains(address)) {
       _curvesAddresses << address;
@@ -1065,13 +1201,21 @@ BasicBox::addCurveAddress(const std::string &address)
 }
 
 void
-BasicBox::removeCurve(const string &address)
+BasicBox::removeCurveAddress(AddressID address)
 {
-  map<string, AbstractCurve*>::iterator it = _abstractCurves.find(address);
+  _curvesAddresses.remove(address);
+}
+
+void
+BasicBox::removeCurve(AddressID address)
+{
+  map<AddressID, AbstractCurve*>::iterator it = _abstractCurves.find(address);
   if (it != _abstractCurves.end()) {
       _abstractCurves.erase(it);
     }
-  _boxContentWidget->removeCurve(address);
+  if (hasContents()) {
+      _boxContentWidget->removeCurve(AddressTable::stdAddress(address));
+    }
 }
 
 void
@@ -1153,6 +1297,10 @@ BasicBox::itemChange(GraphicsItemChange change, const QVariant &value)
 {
   QVariant newValue = QGraphicsItem::itemChange(change, value);
 
+  if (change == ItemSelectedHasChanged && value.toBool()) {
+      materializeContents();
+    }
+
   //QVariant newValue(value);
   if (change == ItemPositionChange) {
       QPointF newPos = value.toPoint();
@@ -1175,6 +1323,7 @@ BasicBox::itemChange(GraphicsItemChange change, const QVariant &value)
                     }
                   else if (_scene->resizeMode() == VERTICAL_RESIZE
                            || _scene->resizeMode() == DIAGONAL_RESIZE) {  // Trying to escape by a resize to the bottom
+                      prepareGeometryChange();
                       _abstract->setHeight(motherBox->getBottomRight().y() - _abstract->topLeft().y());
                       newnewPos.setY(_abstract->topLeft().y() + _abstract->height() / 2);
                     }
@@ -1409,7 +1558,7 @@ BasicBox::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 //    QToolTip::showText(pos, posStr);
 
   if (_scene->resizeMode() == NO_RESIZE && cursor().shape() == Qt::ClosedHandCursor) {
-      _scene->selectionMoved();
+      _scene->postSelectionMoved();
     }
   else if (_scene->resizeMode() != NO_RESIZE && (cursor().shape() == Qt::SizeVerCursor || cursor().shape() == Qt::SizeHorCursor || cursor().shape() == Qt::SizeFDiagCursor)) {
       switch (_scene->resizeMode()) {
@@ -1430,7 +1579,7 @@ BasicBox::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
       nullPath.addRect(QRectF(QPointF(0., 0.), QSizeF(0., 0.)));
       _scene->setSelectionArea(nullPath);
       setSelected(true);
-      _scene->boxResized();
+      _scene->postBoxResized();
     }
 }
 
@@ -1806,8 +1955,14 @@ BasicBox::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidg
   drawInteractionGrips(painter);
   drawTriggerGrips(painter);
 
-  _comboBoxProxy->setVisible(_abstract->height() > RESIZE_TOLERANCE + LINE_WIDTH);
-  _curveProxy->setVisible(_abstract->height() > RESIZE_TOLERANCE + LINE_WIDTH);
+  if (hasContents()) {
+      _scene->touchBoxContents(ID());
+      _comboBoxProxy->setVisible(_abstract->height() > RESIZE_TOLERANCE + LINE_WIDTH);
+      _curveProxy->setVisible(_abstract->height() > RESIZE_TOLERANCE + LINE_WIDTH);
+    }
+  else {
+      _scene->requestBoxContents(ID());
+    }
 
   QBrush brush(Qt::lightGray, isSelected() ? Qt::SolidPattern : Qt::SolidPattern);
   QPen pen(color(), isSelected() ? 2 * LINE_WIDTH : LINE_WIDTH);
@@ -1828,7 +1983,7 @@ BasicBox::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidg
       textRect.setWidth(_abstract->height());
     }
 
-  if (_abstract->width() <= 5 * RESIZE_TOLERANCE) {
+  if (_abstract->width() <= 5 * RESIZE_TOLERANCE && hasContents()) {
       _comboBoxProxy->setVisible(false);
       _curveProxy->setVisible(false);
     }
@@ -1863,10 +2018,9 @@ BasicBox::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidg
       painter->setPen(pen);
       brush.setColor(Qt::blue);
       painter->setBrush(brush);
-      const float progressPosX = _scene->getProgression(_abstract->ID()) * (_abstract->width());
-      painter->fillRect(0, _abstract->height() - RESIZE_TOLERANCE / 2., progressPosX, RESIZE_TOLERANCE / 2., Qt::darkGreen);
+      painter->fillRect(0, _abstract->height() - RESIZE_TOLERANCE / 2., _progressPosX, RESIZE_TOLERANCE / 2., Qt::darkGreen);
 
-      painter->drawLine(QPointF(progressPosX, RESIZE_TOLERANCE), QPointF(progressPosX, _abstract->height()));
+      painter->drawLine(QPointF(_progressPosX, RESIZE_TOLERANCE), QPointF(_progressPosX, _abstract->height()));
     }
   painter->translate(QPointF(0, 0) - _boxRect.topLeft());
 
@@ -1876,7 +2030,7 @@ BasicBox::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidg
 void
 BasicBox::curveShowChanged(const QString &address, bool state)
 {
-  _boxContentWidget->curveShowChanged(address, state);
+  boxContentWidget()->curveShowChanged(address, state);
 }
 
 void
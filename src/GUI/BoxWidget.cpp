@@ -146,7 +146,7 @@ void
 BoxWidget::curveShowChanged(const QString &address, bool state)
 {
   if (_boxID != NO_ID) {
-      AbstractCurve * curve = Maquette::getInstance()->getBox(_boxID)->getCurve(address.toStdString());
+      AbstractCurve * curve = Maquette::getInstance()->getBox(_boxID)->getCurve(AddressTable::intern(address));
       if (curve != NULL && !state) {
           curve->_show = state;
         }
@@ -300,8 +300,9 @@ BoxWidget::updateCurve(const string &address, bool forceUpdate)
   BasicBox *box = Maquette::getInstance()->getBox(_boxID);
 
   if (box != NULL) { // Box Found
-      if (box->hasCurve(address)) {
-          AbstractCurve *abCurve = box->getCurve(address);
+      AddressID addressID = AddressTable::intern(address);
+      if (box->hasCurve(addressID)) {
+          AbstractCurve *abCurve = box->getCurve(addressID);
           QMap<string, CurveWidget *>::iterator curveIt2 = _curveMap->find(address);
           QString curveAddressStr = QString::fromStdString(address);
 
@@ -357,7 +358,7 @@ BoxWidget::updateCurve(const string &address, bool forceUpdate)
                     }
 
                   //Set attributes
-                  box->setCurve(address, curveTab->abstractCurve());
+                  box->setCurve(addressID, curveTab->abstractCurve());
                 }
 
 
@@ -378,7 +379,7 @@ BoxWidget::updateCurve(const string &address, bool forceUpdate)
                   curveTab->setAttributes(_boxID, address, 0, values, sampleRate, redundancy, show, interpolate, argTypes, xPercents, yValues, sectionType, coeff);
                   if (interpolate) {
                       addCurve(curveAddressStr, curveTab);
-                      box->setCurve(address, curveTab->abstractCurve());
+                      box->setCurve(addressID, curveTab->abstractCurve());
                     }
                 }
             }
@@ -169,7 +169,7 @@ CurveWidget::setAttributes(unsigned int boxID,
   _abstract->_redundancy = redundancy;
   _abstract->_show = show;
   _abstract->_interpolate = interpolate;
-  _abstract->_address = address;
+  _abstract->_address = AddressTable::intern(address);
 
   vector<float>::const_iterator it;
   vector<float>::const_iterator it2;
@@ -450,7 +450,7 @@ CurveWidget::curveChanged()
   sectionType.push_back(CURVE_POW);
   coeff.push_back(_abstract->_lastPointCoeff);
 
-  if (Maquette::getInstance()->setCurveSections(_abstract->_boxID, _abstract->_address, 0, xPercents, yValues, sectionType, coeff)) {
+  if (Maquette::getInstance()->setCurveSections(_abstract->_boxID, AddressTable::stdAddress(_abstract->_address), 0, xPercents, yValues, sectionType, coeff)) {
       unsigned int sampleRate;
       bool redundancy, interpolate;
       vector<string> argTypes;
@@ -459,8 +459,8 @@ CurveWidget::curveChanged()
       yValues.clear();
       sectionType.clear();
       coeff.clear();
-      if (Maquette::getInstance()->getCurveAttributes(_abstract->_boxID, _abstract->_address, 0, sampleRate, redundancy, interpolate, values, argTypes, xPercents, yValues, sectionType, coeff)) {
-          setAttributes(_abstract->_boxID, _abstract->_address, 0, values, sampleRate, redundancy, interpolate, _abstract->_show, argTypes, xPercents, yValues, sectionType, coeff);
+      if (Maquette::getInstance()->getCurveAttributes(_abstract->_boxID, AddressTable::stdAddress(_abstract->_address), 0, sampleRate, redundancy, interpolate, values, argTypes, xPercents, yValues, sectionType, coeff)) {
+          setAttributes(_abstract->_boxID, AddressTable::stdAddress(_abstract->_address), 0, values, sampleRate, redundancy, interpolate, _abstract->_show, argTypes, xPercents, yValues, sectionType, coeff);
           update();
           return true;
         }
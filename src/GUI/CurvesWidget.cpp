@@ -119,7 +119,7 @@ void
 CurvesWidget::curveShowChanged(const QString &address, bool state)
 {
   if (_boxID != NO_ID) {
-      AbstractCurve * curve = Maquette::getInstance()->getBox(_boxID)->getCurve(address.toStdString());
+      AbstractCurve * curve = Maquette::getInstance()->getBox(_boxID)->getCurve(AddressTable::intern(address));
       if (curve != NULL) {
           curve->_show = state;
         }
@@ -180,7 +180,7 @@ CurvesWidget::removeCurve(const string &address)
         }
       BasicBox *curveBox = Maquette::getInstance()->getBox(_boxID);
       if (curveBox != NULL) {
-          curveBox->removeCurve(address);
+          curveBox->removeCurve(AddressTable::intern(address));
         }
     }
 }
@@ -225,7 +225,8 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
 {
   BasicBox *box = Maquette::getInstance()->getBox(_boxID);
   if (box != NULL) { // Box Found
-      AbstractCurve *abCurve = box->getCurve(address);
+      AddressID addressID = AddressTable::intern(address);
+      AbstractCurve *abCurve = box->getCurve(addressID);
       map<string, CurveWidget *>::iterator curveIt2 = _curveMap.find(address);
       bool curveFound = (curveIt2 != _curveMap.end());
       unsigned int curveTabIndex = 0;
@@ -250,7 +251,7 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
                       bool getCurveSuccess = Maquette::getInstance()->getCurveAttributes(_boxID, address, 0, sampleRate, redundancy, interpolate, values, argTypes, xPercents, yValues, sectionType, coeff);
                       if (getCurveSuccess) {
                           curveTab->setAttributes(_boxID, address, 0, values, sampleRate, redundancy, FORCE_SHOW, interpolate, argTypes, xPercents, yValues, sectionType, coeff);
-                          box->setCurve(address, curveTab->abstractCurve());
+                          box->setCurve(addressID, curveTab->abstractCurve());
                           if (!_interpolation->updateLine(address, interpolate, sampleRate, redundancy, FORCE_SHOW)) {
                               _interpolation->addLine(address, interpolate, sampleRate, redundancy, FORCE_SHOW);
                             }
@@ -281,7 +282,7 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
                           displayCurve(_comboBox->currentText());
 
                           // Set box curve
-                          box->setCurve(address, curveTab->abstractCurve());
+                          box->setCurve(addressID, curveTab->abstractCurve());
                           if (!_interpolation->updateLine(address, interpolate, sampleRate, redundancy, FORCE_SHOW)) {
                               _interpolation->addLine(address, interpolate, sampleRate, redundancy, FORCE_SHOW);
                             }
@@ -320,7 +321,7 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
                               // Set and assign new abstract curve to box
                               curveTab->setAttributes(_boxID, address, 0, values, sampleRate, redundancy, FORCE_HIDE, interpolate, argTypes, xPercents, yValues, sectionType, coeff);
                             }
-                          box->setCurve(address, curveTab->abstractCurve());
+                          box->setCurve(addressID, curveTab->abstractCurve());
                         }
                     }
 
@@ -344,7 +345,7 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
                           // Create, set and assign new abstract curve to box
                           curveTab = new CurveWidget(NULL);
                           curveTab->setAttributes(_boxID, address, 0, values, sampleRate, redundancy, FORCE_HIDE, interpolate, argTypes, xPercents, yValues, sectionType, coeff);
-                          box->setCurve(address, curveTab->abstractCurve());
+                          box->setCurve(addressID, curveTab->abstractCurve());
                           if (!_interpolation->updateLine(address, interpolate, sampleRate, redundancy, FORCE_HIDE)) {
                               _interpolation->addLine(address, interpolate, sampleRate, redundancy, FORCE_HIDE);
                             }
@@ -391,7 +392,7 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
                   curveTab->setAttributes(_boxID, address, 0, values, sampleRate, redundancy, FORCE_SHOW, interpolate, argTypes, xPercents, yValues, sectionType, coeff);
 
                   // Set box curve
-                  box->setCurve(address, curveTab->abstractCurve());
+                  box->setCurve(addressID, curveTab->abstractCurve());
                   if (!_interpolation->updateLine(address, interpolate, sampleRate, redundancy, FORCE_SHOW)) {
                       _interpolation->addLine(address, interpolate, sampleRate, redundancy, FORCE_SHOW);
                     }
@@ -401,7 +402,7 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
                       // Creating curve tab from engines anyway (no abstract curve)
                       // Set and assign new abstract curve to box
                       curveTab->setAttributes(_boxID, address, 0, values, sampleRate, redundancy, FORCE_HIDE, interpolate, argTypes, xPercents, yValues, sectionType, coeff);
-                      box->setCurve(address, curveTab->abstractCurve());
+                      box->setCurve(addressID, curveTab->abstractCurve());
 
                       // Remove curve tab
                       removeCurve(address);
@@ -411,7 +412,7 @@ CurvesWidget::updateCurve(const string &address, bool forceUpdate)
                          // Creating curve tab from engines anyway (no abstract curve)
                       curveTab = new CurveWidget(NULL);
                       curveTab->setAttributes(_boxID, address, 0, values, sampleRate, redundancy, FORCE_HIDE, interpolate, argTypes, xPercents, yValues, sectionType, coeff);
-                      box->setCurve(address, curveTab->abstractCurve());
+                      box->setCurve(addressID, curveTab->abstractCurve());
                       delete curveTab;
                     }
 
@@ -60,7 +60,7 @@
 #include "AbstractRelation.hpp"
 #include "AbstractComment.hpp"
 #include "TextEdit.hpp"
-#include "PlayingThread.hpp"
+#include "PlaybackClock.hpp"
 #include "CurvesWidget.hpp"
 #include "TimeBarWidget.hpp"
 #include <QGraphicsProxyWidget>
@@ -68,6 +68,7 @@
 
 #include <sstream>
 #include <map>
+#include <algorithm>
 #include <cmath>
 
 using std::map;
@@ -86,11 +87,21 @@ MaquetteScene::MaquetteScene(const QRectF & rect, AttributesEditor *editor)
   _clicked = false;
   _playing = false;
   _paused = false;
+  _playheadOverlay = true;
+  _snapshotTime = 0;
+  _repaintedArea = 0.;
+  _repaintedPixelsPerSecond = 0;
   _modified = false;
   _maxSceneWidth = 100000;
+  _view = NULL;
+  _deferredEditing = true;
+  _selectionMovePending = false;
+  _resizePending = false;
+  _lazyContents = true;
+  _contentsBudget = CONTENTS_BUDGET;
 
   _relation = new AbstractRelation; /// \todo pourquoi instancier une AbstractRelation ici ?
-  _playThread = new PlayingThread(this);
+  _playbackClock = new PlaybackClock(this);
   _timeBar = new TimeBarWidget(0, this);  
   _timeBarProxy = addWidget(_timeBar);/// \todo Vérifier ajout si classe TimeBarWidget hérite de GraphicsProxyWidget ou GraphicsObject. Notamment pour lier avec background.
 
@@ -101,6 +112,7 @@ MaquetteScene::MaquetteScene(const QRectF & rect, AttributesEditor *editor)
 
 MaquetteScene::~MaquetteScene()
 {
+  delete _playbackClock;
   delete _tempBox;
   delete _maquette;
 }
@@ -129,7 +141,7 @@ MaquetteScene::init()
   _maquette->init();
 
   _tempBox = NULL;
-  _resizeBox = NO_ID;
+  _resizeBox = EntityStore<BasicBox*>::Handle(NO_ID);
 
   _relation->setFirstBox(NO_ID);
   _relation->setSecondBox(NO_ID);
@@ -144,13 +156,54 @@ MaquetteScene::init()
 void
 MaquetteScene::updateProgressBar()
 {
+  QRectF oldStrip = _progressLine->sceneBoundingRect();
+
+  // Moving the line already invalidates its previous and new strips
   if (_playing) {      
-      _progressLine->setPos(_maquette->getCurrentTime() / MS_PER_PIXEL, sceneRect().topLeft().y());
-      invalidate();
+      _progressLine->setPos(_snapshotTime / MS_PER_PIXEL, sceneRect().topLeft().y());
     }
   else {      
       _progressLine->setPos(_view->gotoValue() / MS_PER_PIXEL, sceneRect().topLeft().y());
+    }
+
+  if (_playheadOverlay) {
+      countRepaintedArea(oldStrip);
+      countRepaintedArea(_progressLine->sceneBoundingRect());
+    }
+  else {
       invalidate();
+      countRepaintedArea(sceneRect());
+    }
+}
+
+void
+MaquetteScene::countRepaintedArea(const QRectF &rect)
+{
+  if (!_repaintClock.isValid()) {
+      _repaintClock.start();
+    }
+
+  if (_view != NULL) {
+      QRectF visible = _view->mapToScene(_view->viewport()->rect()).boundingRect();
+      QRectF repainted = rect.intersected(visible);
+      _repaintedArea += repainted.width() * repainted.height();
+    }
+
+  qint64 elapsed = _repaintClock.elapsed();
+  if (elapsed >= 1000) {
+      _repaintedPixelsPerSecond = (unsigned int)(_repaintedArea * 1000 / elapsed);
+      _repaintedArea = 0.;
+      _repaintClock.restart();
+    }
+}
+
+void
+MaquetteScene::setPlayheadOverlay(bool overlay)
+{
+  _playheadOverlay = overlay;
+  if (_view != NULL) {
+      // Bounding rect updates would merge distant strips into a single wide area
+      _view->setViewportUpdateMode(_playheadOverlay ? QGraphicsView::SmartViewportUpdate : QGraphicsView::BoundingRectViewportUpdate);
     }
 }
 
@@ -177,6 +230,7 @@ void
 MaquetteScene::updateView()
 {
   _view = static_cast<MaquetteView*>(views().front());
+  setPlayheadOverlay(_playheadOverlay);
 }
 
 /// \todo Vérifier l'utilité de faire une surcouche d'appels de méthodes de AttributesEditor (_editor)
@@ -260,9 +314,20 @@ MaquetteScene::getCurrentTime()
   return _maquette->getCurrentTime();
 }
 
+static bool
+sampleBefore(const ProgressionSample &sample, unsigned int boxID)
+{
+  return sample.boxID < boxID;
+}
+
 float
 MaquetteScene::getProgression(unsigned int boxID)
 {
+  vector<ProgressionSample>::const_iterator it = std::lower_bound(_progressionSnapshot.begin(), _progressionSnapshot.end(), boxID, sampleBefore);
+  if (it != _progressionSnapshot.end() && it->boxID == boxID) {
+      return it->progression;
+    }
+
   return _maquette->getProgression(boxID);
 }
 
@@ -316,10 +381,11 @@ MaquetteScene::drawForeground(QPainter * painter, const QRectF & rect)
                       double endX = 0., endY = 0.;
                       static const double arrowSize = 12.;
                       BasicBox *box = NULL;
-                      if (itemAt(_mousePos) != 0) {
-                          int type = itemAt(_mousePos)->type();
+                      QGraphicsItem *item = itemAt(_mousePos);
+                      if (item != 0) {
+                          int type = item->type();
                           if (type == PARENT_BOX_TYPE) {
-                              box = static_cast<BasicBox*>(itemAt(_mousePos));
+                              box = static_cast<BasicBox*>(item);
                               if (_mousePos.x() < (box->mapToScene(box->boundingRect().topLeft()).x()
                                                    + BasicBox::RESIZE_TOLERANCE)) {
                                   endX = box->getLeftGripPoint().x();
@@ -572,10 +638,11 @@ MaquetteScene::mouseMoveEvent(QGraphicsSceneMouseEvent * mouseEvent)
                 if (_relation->firstBox() != NO_ID) {
                     update();
                   }
-                if (itemAt(mouseEvent->scenePos()) != 0) {
-                    int type = itemAt(mouseEvent->scenePos())->type();
+                QGraphicsItem *item = itemAt(mouseEvent->scenePos());
+                if (item != 0) {
+                    int type = item->type();
                     if (type == PARENT_BOX_TYPE) {
-                        BasicBox *secondBox = static_cast<BasicBox*>(itemAt(mouseEvent->scenePos()));
+                        BasicBox *secondBox = static_cast<BasicBox*>(item);
                         if (mouseEvent->scenePos().x() < (secondBox->mapToScene(secondBox->boundingRect().topLeft()).x() + BasicBox::RESIZE_TOLERANCE) ||
                             mouseEvent->scenePos().x() > (secondBox->mapToScene(secondBox->boundingRect().bottomRight()).x() - BasicBox::RESIZE_TOLERANCE)) {
                             _relationBoxFound = true;
@@ -637,6 +704,8 @@ MaquetteScene::mouseMoveEvent(QGraphicsSceneMouseEvent * mouseEvent)
 void
 MaquetteScene::mouseReleaseEvent(QGraphicsSceneMouseEvent * mouseEvent)
 {
+  // The dropped position is solved before the items handle the release
+  flushPendingEdits();
   QGraphicsScene::mouseReleaseEvent(mouseEvent);
 
   _releasePoint = mouseEvent->scenePos();
@@ -644,35 +713,25 @@ MaquetteScene::mouseReleaseEvent(QGraphicsSceneMouseEvent * mouseEvent)
   switch (_currentInteractionMode) {
       case RELATION_MODE:
 
-        if (itemAt(mouseEvent->scenePos()) != 0) {
-            int type = itemAt(mouseEvent->scenePos())->type();
-            if (type == PARENT_BOX_TYPE) {
-                BasicBox *secondBox = static_cast<BasicBox*>(itemAt(mouseEvent->scenePos()));
-
-                BasicBox *firstBox = getBox(_relation->firstBox());
-                if (mouseEvent->scenePos().x() < (secondBox->mapToScene(secondBox->boundingRect().topLeft()).x() + BasicBox::RESIZE_TOLERANCE)) {
-                    setRelationSecondBox(secondBox->ID(), BOX_START);
-                    addPendingRelation();
-                    firstBox->setSelected(true);
-                  }
-                else if (mouseEvent->scenePos().x() > (secondBox->mapToScene(secondBox->boundingRect().bottomRight()).x() - BasicBox::RESIZE_TOLERANCE)) {
-                    setRelationSecondBox(secondBox->ID(), BOX_END);
-                    addPendingRelation();
-                    firstBox->setSelected(true);
+        if (BasicBox *secondBox = boxAt(mouseEvent->scenePos())) {
+            BasicBox *firstBox = getBox(_relation->firstBox());
+            if (mouseEvent->scenePos().x() < (secondBox->mapToScene(secondBox->boundingRect().topLeft()).x() + BasicBox::RESIZE_TOLERANCE)) {
+                setRelationSecondBox(secondBox->ID(), BOX_START);
+                addPendingRelation();
+                firstBox->setSelected(true);
+              }
+            else if (mouseEvent->scenePos().x() > (secondBox->mapToScene(secondBox->boundingRect().bottomRight()).x() - BasicBox::RESIZE_TOLERANCE)) {
+                setRelationSecondBox(secondBox->ID(), BOX_END);
+                addPendingRelation();
+                firstBox->setSelected(true);
+              }
+            else {
+                if (selectedItems().empty()) {
                   }
                 else {
-                    if (selectedItems().empty()) {
-                      }
-                    else {
-                        selectionMoved();
-                      }
+                    selectionMoved();
                   }
               }
-            else {
-                _relationBoxFound = false;
-                delete _relation;
-                _relation = new AbstractRelation;
-              }
           }
         else {
             _relationBoxFound = false;
@@ -728,7 +787,7 @@ void
 MaquetteScene::contextMenuEvent(QGraphicsSceneContextMenuEvent * event)
 {
   _tempBox = NULL;
-  _resizeBox = NO_ID;
+  _resizeBox = EntityStore<BasicBox*>::Handle(NO_ID);
   _relation->setFirstBox(NO_ID);
   _relation->setSecondBox(NO_ID);
   _relationBoxFound = false;
@@ -744,7 +803,15 @@ MaquetteScene::contextMenuEvent(QGraphicsSceneContextMenuEvent * event)
 void
 MaquetteScene::setResizeBox(unsigned int box)
 {
-  _resizeBox = box;
+  _resizeBox = _maquette->getBoxes().handle(box);
+}
+
+BasicBox *
+MaquetteScene::resizingBox()
+{
+  const EntityStore<BasicBox*> &boxes = _maquette->getBoxes();
+  EntityStore<BasicBox*>::const_iterator it = boxes.find(_resizeBox);
+  return it != boxes.end() ? it->second : NULL;
 }
 
 int
@@ -1110,6 +1177,28 @@ MaquetteScene::setTriggerPointMessage(unsigned int trgID, const string &message)
   return _maquette->setTriggerPointMessage(trgID, message);
 }
 
+BasicBox *
+MaquetteScene::boxAt(const QPointF &pos)
+{
+  QGraphicsItem *item = itemAt(pos);
+  if (item != NULL && item->type() == PARENT_BOX_TYPE) {
+      return static_cast<BasicBox*>(item);
+    }
+  return NULL;
+}
+
+void
+MaquetteScene::boxesIntersecting(const QRectF &rect, QList<BasicBox*> &boxes)
+{
+  boxes.clear();
+  QList<QGraphicsItem*> intersected = items(rect, Qt::IntersectsItemBoundingRect);
+  for (QList<QGraphicsItem*>::iterator it = intersected.begin(); it != intersected.end(); ++it) {
+      if ((*it)->type() == PARENT_BOX_TYPE) {
+          boxes.push_back(static_cast<BasicBox*>(*it));
+        }
+    }
+}
+
 unsigned int
 MaquetteScene::findMother(const QPointF &topLeft, const QPointF &size)
 {
@@ -1117,26 +1206,30 @@ MaquetteScene::findMother(const QPointF &topLeft, const QPointF &size)
   std::cerr << "MaquetteScene::findMother : child coords : [" << topLeft.x() << ";" << topLeft.y()
             << "] / [" << size.x() << ";" << size.y() << "]" << std::endl;
 #endif
-  map<unsigned int, ParentBox*> parentBoxes = _maquette->parentBoxes(); /// \todo Mieux vaut parcourir les ParentBoxes contenus dans la scene, pas aller les chercher dans Maquette car on perd l'intérêt d'utiliser le Graphics View Framework
+  QRectF childRect = QRectF(topLeft, QSize(size.x(), size.y())); /// \todo
+
+  // Only the boxes intersecting the child can contain it
+  QList<BasicBox*> candidates;
+  boxesIntersecting(childRect, candidates);
 #ifdef DEBUG
-  std::cerr << "MaquetteScene::findMother : parentBoxes size : " << parentBoxes.size() << std::endl;
+  std::cerr << "MaquetteScene::findMother : candidates : " << candidates.size() << std::endl;
 #endif
-  map<unsigned int, ParentBox*>::iterator it;
+
+  // The innermost mother is the smallest box containing the child
   unsigned int motherID = ROOT_BOX_ID;
-  float motherZValue = std::numeric_limits<float>::min();
-  QRectF childRect = QRectF(topLeft, QSize(size.x(), size.y())); /// \todo
-  for (it = parentBoxes.begin(); it != parentBoxes.end(); ++it) {
-      QRectF mRect = QRectF(it->second->getTopLeft(), QSize(it->second->getSize().x(), it->second->getSize().y()));
+  qreal motherArea = std::numeric_limits<qreal>::max();
+  for (QList<BasicBox*>::iterator it = candidates.begin(); it != candidates.end(); ++it) {
+      QRectF mRect = QRectF((*it)->getTopLeft(), QSize((*it)->getSize().x(), (*it)->getSize().y()));
 #ifdef DEBUG
       std::cerr << "MaquetteScene::findMother : possible mother coords : [" << mRect.topLeft().x() << ";" << mRect.topLeft().y()
                 << "] / [" << mRect.size().width() << ";" << mRect.size().height() << "]" << std::endl;
 #endif
-      if (mRect.contains(childRect) && !childRect.contains(mRect)) {
+      if (mRect.contains(childRect) && !childRect.contains(mRect) && mRect.width() * mRect.height() < motherArea) {
 #ifdef DEBUG
-          std::cerr << "MaquetteScene::findMother : newMother : " << it->first << std::endl;
+          std::cerr << "MaquetteScene::findMother : newMother : " << (*it)->ID() << std::endl;
 #endif
-          motherID = it->first;
-          motherZValue = it->second->zValue();
+          motherID = (*it)->ID();
+          motherArea = mRect.width() * mRect.height();
         }
     }
   return motherID;
@@ -1187,6 +1280,18 @@ MaquetteScene::addParentBox(unsigned int ID)
   return NO_ID;
 }
 
+void
+MaquetteScene::addParentBoxes(const vector<unsigned int> &IDs)
+{
+  // Indexing is paused while items are added, the index being rebuilt once when restored
+  ItemIndexMethod indexMethod = itemIndexMethod();
+  setItemIndexMethod(NoIndex);
+  for (vector<unsigned int>::const_iterator it = IDs.begin(); it != IDs.end(); ++it) {
+      addParentBox(*it);
+    }
+  setItemIndexMethod(indexMethod);
+}
+
 unsigned int
 MaquetteScene::addParentBox(const QPointF &topLeft, const QPointF &bottomRight, const string &name)
 {
@@ -1394,7 +1499,7 @@ MaquetteScene::setRelationSecondBox(unsigned int ID, BoxExtremity extremumType)
 void
 MaquetteScene::boxResized()
 {
-  BasicBox* resizeBox = getBox(_resizeBox);
+  BasicBox* resizeBox = resizingBox();
   Coords coord;
   coord.topLeftX = resizeBox->relativeBeginPos();
   coord.topLeftY = resizeBox->getTopLeft().y();
@@ -1410,14 +1515,182 @@ MaquetteScene::boxResized()
 void
 MaquetteScene::selectionMoved()
 {
-  for (int i = 0; i < selectedItems().size(); i++) {
-      QGraphicsItem *curItem = selectedItems().at(i);
+  QList<QGraphicsItem *> selection = selectedItems();
+  _maquette->beginEdit();
+  for (int i = 0; i < selection.size(); i++) {
+      QGraphicsItem *curItem = selection.at(i);
       int type = curItem->type();
       if (type == PARENT_BOX_TYPE) {
           BasicBox *curBox = static_cast<BasicBox*>(curItem);
           boxMoved(curBox->ID());
         }
     }
+  _maquette->commitEdit();
+}
+
+void
+MaquetteScene::postSelectionMoved()
+{
+  if (!_deferredEditing) {
+      selectionMoved();
+      return;
+    }
+  _selectionMovePending = true;
+  if (!_editTimer.isActive()) {
+      _editTimer.start(EDIT_FRAME_INTERVAL, this);
+    }
+}
+
+void
+MaquetteScene::postBoxResized()
+{
+  if (!_deferredEditing) {
+      boxResized();
+      return;
+    }
+  _resizePending = true;
+  if (!_editTimer.isActive()) {
+      _editTimer.start(EDIT_FRAME_INTERVAL, this);
+    }
+}
+
+void
+MaquetteScene::flushPendingEdits()
+{
+  _editTimer.stop();
+  if (_selectionMovePending) {
+      _selectionMovePending = false;
+      selectionMoved();
+    }
+  if (_resizePending) {
+      _resizePending = false;
+      // The box may have been removed, and its ID given to a new box, before the frame
+      if (resizingBox() != NULL) {
+          boxResized();
+        }
+    }
+}
+
+void
+MaquetteScene::setDeferredEditing(bool deferred)
+{
+  _deferredEditing = deferred;
+  if (!_deferredEditing) {
+      flushPendingEdits();
+    }
+}
+
+void
+MaquetteScene::requestBoxContents(unsigned int ID)
+{
+  if (ID == NO_ID) {
+      return;
+    }
+  _contentsRequests.insert(ID);
+  if (!_contentsTimer.isActive()) {
+      _contentsTimer.start(EDIT_FRAME_INTERVAL, this);
+    }
+}
+
+void
+MaquetteScene::touchBoxContents(unsigned int ID)
+{
+  if (ID == NO_ID || !_lazyContents) {
+      return;
+    }
+  std::map<unsigned int, std::list<unsigned int>::iterator>::iterator it = _contentsUsageIndex.find(ID);
+  if (it != _contentsUsageIndex.end()) {
+      _contentsUsage.splice(_contentsUsage.end(), _contentsUsage, it->second);
+    }
+  else {
+      _contentsUsageIndex[ID] = _contentsUsage.insert(_contentsUsage.end(), ID);
+    }
+}
+
+void
+MaquetteScene::materializeRequestedContents()
+{
+  unsigned int count = 0;
+  std::set<unsigned int>::iterator it = _contentsRequests.begin();
+  while (it != _contentsRequests.end() && count < CONTENTS_PER_FRAME) {
+      BasicBox *box = getBox(*it);
+      if (box != NULL && !box->hasContents()) {
+          box->materializeContents();
+          count++;
+        }
+      _contentsRequests.erase(it++);
+    }
+  if (_contentsRequests.empty()) {
+      _contentsTimer.stop();
+    }
+  trimBoxContents();
+}
+
+void
+MaquetteScene::trimBoxContents()
+{
+  if (!_lazyContents) {
+      return;
+    }
+
+  QRectF visibleArea;
+  if (_view != NULL) {
+      visibleArea = _view->mapToScene(_view->viewport()->rect()).boundingRect();
+    }
+
+  // Boxes are identified by ID, entries of deleted boxes being dropped here
+  std::list<unsigned int>::iterator it = _contentsUsage.begin();
+  while (_contentsUsageIndex.size() > _contentsBudget && it != _contentsUsage.end()) {
+      BasicBox *box = getBox(*it);
+      if (box != NULL && (box->isSelected() || box->sceneBoundingRect().intersects(visibleArea))) {
+          ++it;
+          continue;
+        }
+      if (box != NULL) {
+          box->releaseContents();
+        }
+      _contentsUsageIndex.erase(*it);
+      it = _contentsUsage.erase(it);
+    }
+}
+
+void
+MaquetteScene::setLazyContents(bool lazy)
+{
+  _lazyContents = lazy;
+  if (!_lazyContents) {
+      _contentsTimer.stop();
+      _contentsRequests.clear();
+      _contentsUsage.clear();
+      _contentsUsageIndex.clear();
+
+      const EntityStore<BasicBox*> &boxes = _maquette->getBoxes();
+      EntityStore<BasicBox*>::const_iterator it;
+      for (it = boxes.begin(); it != boxes.end(); ++it) {
+          it->second->materializeContents();
+        }
+    }
+}
+
+void
+MaquetteScene::setContentsBudget(unsigned int budget)
+{
+  _contentsBudget = budget;
+  trimBoxContents();
+}
+
+void
+MaquetteScene::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() == _editTimer.timerId()) {
+      flushPendingEdits();
+    }
+  else if (event->timerId() == _contentsTimer.timerId()) {
+      materializeRequestedContents();
+    }
+  else {
+      QGraphicsScene::timerEvent(event);
+    }
 }
 
 bool
@@ -1460,9 +1733,11 @@ MaquetteScene::boxMoved(unsigned int boxID)
 void
 MaquetteScene::boxesMoved(const vector<unsigned int> &moved)
 {
+  _maquette->beginEdit();
   for (unsigned int i = 0; i < moved.size(); i++) {
       boxMoved(moved[i]);
     }
+  _maquette->commitEdit();
 }
 
 void
@@ -1559,8 +1834,24 @@ MaquetteScene::updatePlayingBoxes()
 {
   map<unsigned int, BasicBox*>::iterator it;
 
+  // Playing boxes are sorted by ID, and so is the snapshot
+  _snapshotTime = _maquette->getCurrentTime();
+  _progressionSnapshot.resize(_playingBoxes.size());
+  unsigned int i = 0;
+  for (it = _playingBoxes.begin(); it != _playingBoxes.end(); ++it, ++i) {
+      _progressionSnapshot[i].boxID = it->first;
+      _progressionSnapshot[i].progression = _maquette->getProgression(it->first);
+      _progressionSnapshot[i].currentTime = _snapshotTime;
+    }
+
   for (it = _playingBoxes.begin(); it != _playingBoxes.end(); ++it) {
-      it->second->update();
+      if (_playheadOverlay) {
+          countRepaintedArea(it->second->updateProgress());
+        }
+      else {
+          it->second->updateProgress();
+          it->second->update();
+        }
     }
 }
 
@@ -1572,15 +1863,16 @@ MaquetteScene::play()
       _playing = true;
       _maquette->setAccelerationFactor(_accelerationFactor);
       _maquette->startPlaying();
-      _playThread->start();
+      _playbackClock->start();
       _paused = false;
     }
   else {
       _playing = true;
       _maquette->startPlaying();
-      _playThread->start();
+      _playbackClock->start();
       _startingValue = _view->gotoValue();
     }  
+  _snapshotTime = _maquette->getCurrentTime();
   emit(playModeChanged());
 }
 
@@ -1591,7 +1883,7 @@ MaquetteScene::pause()
   _playing = false;
   _paused = true;
   _maquette->pause();
-  _playThread->quit();
+  _playbackClock->stop();
   _accelerationFactorSave = _maquette->accelerationFactor();
   _maquette->setAccelerationFactor(0.);
   update();
@@ -1604,8 +1896,9 @@ MaquetteScene::stop()
 {
   _playing = false;
   _maquette->stopPlaying();
-  _playThread->quit();
+  _playbackClock->stop();
   _playingBoxes.clear();
+  _progressionSnapshot.clear();
   update();
   emit(playModeChanged());
 }
@@ -1616,8 +1909,9 @@ MaquetteScene::stopWithGoto()
   displayMessage(tr("Stopped").toStdString(), INDICATION_LEVEL);
   _playing = false;
   _maquette->stopPlayingWithGoto();
-  _playThread->quit();
+  _playbackClock->stop();
   _playingBoxes.clear();
+  _progressionSnapshot.clear();
   update();
   emit(playModeChanged());
 }
@@ -1645,8 +1939,9 @@ MaquetteScene::stopGotoStart()
   _maquette->setAccelerationFactor(1.);
   emit(accelerationValueChanged(1.));
   _maquette->stopPlayingGotoStart();
-  _playThread->quit();
+  _playbackClock->stop();
   _playingBoxes.clear();
+  _progressionSnapshot.clear();
   update();
   emit(playModeChanged());
 }
@@ -1722,8 +2017,8 @@ MaquetteScene::load(const string &fileName)
 void
 MaquetteScene::updateBoxesWidgets()
 {
-  std::map<unsigned int, BasicBox*>::iterator it;
-  std::map<unsigned int, BasicBox*> boxes = _maquette->getBoxes();
+  EntityStore<BasicBox*>::const_iterator it;
+  const EntityStore<BasicBox*> &boxes = _maquette->getBoxes();
   for (it = boxes.begin(); it != boxes.end(); it++) {
       unsigned int boxID = it->first;
       if (boxID != NO_ID) {
@@ -1732,20 +2027,19 @@ MaquetteScene::updateBoxesWidgets()
     }
 }
 
+static bool
+triggerBefore(TriggerPoint *trigger, unsigned int date)
+{
+  return Maquette::getInstance()->triggerDate(trigger->ID()) < date;
+}
+
 void
 MaquetteScene::addToTriggerQueue(TriggerPoint *trigger)
 {
   if (!_triggersQueueList->contains(trigger)) {
-      int i;
-      qreal trgPosition = trigger->pos().x();
-
-      for (i = 0; i < _triggersQueueList->size(); i++) {
-          qreal itPosition = _triggersQueueList->at(i)->pos().x();
-          if (trgPosition <= itPosition) {
-              break;
-            }
-        }
-      _triggersQueueList->insert(i, trigger);
+      unsigned int date = _maquette->triggerDate(trigger->ID());
+      QList<TriggerPoint *>::iterator it = std::lower_bound(_triggersQueueList->begin(), _triggersQueueList->end(), date, triggerBefore);
+      _triggersQueueList->insert(it, trigger);
     }
 }
 
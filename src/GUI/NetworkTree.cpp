@@ -487,7 +487,7 @@ NetworkTree::getDeviceName(QTreeWidgetItem *item) const
 QTreeWidgetItem *
 NetworkTree::getItemFromAddress(string address) const
 {
-  return _addressMap.key(address);
+  return _addressItems.value(AddressTable::find(QString::fromStdString(address)), NULL);
 }
 
 QPair< QMap <QTreeWidgetItem *, Data>, QList<QString> >
@@ -522,7 +522,7 @@ NetworkTree::treeSnapshot(unsigned int boxID)
                   Data data;
                   for (it2 = snapshot.begin(); it2 != snapshot.end(); it2++) {
                       data.msg = QString::fromStdString(*it2);
-                      data.address = address;
+                      data.address = AddressTable::intern(address);
 
 //                        data.sampleRate = Maquette::getInstance()->getCurveSampleRate(boxID,address.toStdString());
                       data.hasCurve = false;
@@ -539,7 +539,7 @@ NetworkTree::treeSnapshot(unsigned int boxID)
 bool
 NetworkTree::hasStartEndMsg(QTreeWidgetItem *item)
 {
-  return(_startMessages->getMessages()->contains(item) || _endMessages->getMessages()->contains(item));
+  return(_startMessages->contains(item) || _endMessages->contains(item));
 }
 
 
@@ -553,7 +553,7 @@ NetworkTree::treeRecursiveExploration(QTreeWidgetItem *curItem, bool conflict)
   if (!curItem->isDisabled()) {
       vector<string> nodes, leaves, attributes, attributesValues;
       QString address = getAbsoluteAddress(curItem);
-      _addressMap.insert(curItem, address.toStdString());
+      _addressItems.insert(AddressTable::intern(address), curItem);
 
       int request = Maquette::getInstance()->requestNetworkNamespace(address.toStdString(), nodes, leaves, attributes, attributesValues);
       bool requestSuccess = request > 0;
@@ -694,7 +694,7 @@ NetworkTree::updateStartOSCMsgsDisplay()
 
   for (it = items.begin(); it != items.end(); it++) {
       curItem = *it;
-      currentMsg = _OSCStartMessages->getMessages()->value(curItem);
+      currentMsg = _OSCStartMessages->message(curItem);
       curItem->setText(START_COLUMN, currentMsg.value);
       curItem->setFont(NAME_COLUMN, font);
     }
@@ -712,7 +712,7 @@ NetworkTree::updateEndOSCMsgsDisplay()
 
   for (it = items.begin(); it != items.end(); it++) {
       curItem = *it;
-      currentMsg = _OSCEndMessages->getMessages()->value(curItem);
+      currentMsg = _OSCEndMessages->message(curItem);
       curItem->setText(END_COLUMN, currentMsg.value);
       curItem->setFont(NAME_COLUMN, font);
     }
@@ -729,7 +729,7 @@ NetworkTree::updateStartMsgsDisplay()
 //    clearColumn(START_COLUMN);
   for (it = items.begin(); it != items.end(); it++) {
       curItem = *it;
-      currentMsg = _startMessages->getMessages()->value(curItem);
+      currentMsg = _startMessages->message(curItem);
       curItem->setText(START_COLUMN, currentMsg.value);
       fatherColumnCheck(curItem, START_COLUMN);
     }
@@ -776,7 +776,7 @@ NetworkTree::updateEndMsgsDisplay()
 
   for (it = items.begin(); it != items.end(); it++) {
       curItem = *it;
-      currentMsg = _endMessages->getMessages()->value(curItem);
+      currentMsg = _endMessages->message(curItem);
       curItem->setText(END_COLUMN, currentMsg.value);
 
       fatherColumnCheck(curItem, END_COLUMN);
@@ -947,7 +947,7 @@ NetworkTree::assignItems(QList<QTreeWidgetItem*> selectedItems)
 
   for (it = selectedItems.begin(); it != selectedItems.end(); ++it) {
       curItem = *it;
-      data.address = getAbsoluteAddress(curItem);
+      data.address = AddressTable::intern(getAbsoluteAddress(curItem));
       assignItem(curItem, data);
     }
 }
@@ -1525,7 +1525,7 @@ NetworkTree::valueChanged(QTreeWidgetItem* item, int column)
 {
   Data data;
   data.hasCurve = false;
-  data.address = getAbsoluteAddress(item);
+  data.address = AddressTable::intern(getAbsoluteAddress(item));
 
   if (item->type() == LeaveType && column == START_COLUMN && VALUE_MODIFIED) {
       VALUE_MODIFIED = FALSE;
@@ -1594,13 +1594,13 @@ NetworkTree::changeStartValue(QTreeWidgetItem *item, QString newValue)
       if (item->type() == OSCNode) {
           _OSCStartMessages->removeMessage(item);
         }
-      if (!endMessages()->getMessages()->contains(item)) {
+      if (!endMessages()->contains(item)) {
           removeAssignItem(item);
         }
       emit(startMessageValueChanged(item));
     }
   else {
-      if (!_startMessages->getMessages()->contains(item)) {
+      if (!_startMessages->contains(item)) {
           QString Qaddress = getAbsoluteAddressWithValue(item, START_COLUMN);
           _startMessages->addMessage(item, Qaddress);
           Data data;
@@ -1634,13 +1634,13 @@ NetworkTree::changeEndValue(QTreeWidgetItem *item, QString newValue)
       if (item->type() == OSCNode) {
           _OSCEndMessages->removeMessage(item);
         }
-      if (!startMessages()->getMessages()->contains(item)) {
+      if (!startMessages()->contains(item)) {
           removeAssignItem(item);
         }
       emit(endMessageValueChanged(item));
     }
   else {
-      if (!_endMessages->getMessages()->contains(item)) {
+      if (!_endMessages->contains(item)) {
           QString Qaddress = getAbsoluteAddressWithValue(item, END_COLUMN);
           _endMessages->addMessage(item, Qaddress);
           if (item->type() == OSCNode) {
@@ -1731,7 +1731,8 @@ NetworkTree::updateCurve(QTreeWidgetItem *item, unsigned int boxID, bool forceUp
   string address = getAbsoluteAddress(item).toStdString();
   BasicBox *box = Maquette::getInstance()->getBox(boxID);
   if (box != NULL) { // Box Found
-      if (box->hasCurve(address)) {
+      AddressID addressID = AddressTable::intern(address);
+      if (box->hasCurve(addressID)) {
           if (_assignedItems.value(item).hasCurve) {
               unsigned int sampleRate;
               bool redundancy, interpolate;
@@ -100,6 +100,13 @@ ParentBox::init()
   setAcceptDrops(true);
 }
 
+void
+ParentBox::createContents()
+{
+  BasicBox::createContents();
+  addToComboBox(BasicBox::SUB_SCENARIO_MODE_TEXT);
+}
+
 Abstract*
 ParentBox::abstract() const
 {
@@ -175,7 +182,7 @@ ParentBox::removeChild(unsigned int childID)
     }
 }
 
-map<unsigned int, BasicBox*>
+const map<unsigned int, BasicBox*> &
 ParentBox::children() const
 {
   return _children;
@@ -296,7 +303,7 @@ ParentBox::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
 {
   QGraphicsItem::mouseMoveEvent(event);
   if (_scene->resizeMode() == NO_RESIZE && cursor().shape() == Qt::ClosedHandCursor) {
-      _scene->selectionMoved();
+      _scene->postSelectionMoved();
     }
   else if (_scene->resizeMode() != NO_RESIZE && (cursor().shape() == Qt::SizeVerCursor
                                                  || cursor().shape() == Qt::SizeHorCursor || cursor().shape() == Qt::SizeFDiagCursor)) {
@@ -317,7 +324,7 @@ ParentBox::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
       nullPath.addRect(QRectF(QPointF(0., 0.), QSizeF(0., 0.)));
       _scene->setSelectionArea(nullPath);
       setSelected(true);
-      _scene->boxResized();
+      _scene->postBoxResized();
     }
 }
 
@@ -0,0 +1,146 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file PlaybackClock.cpp
+ */
+
+#include "PlaybackClock.hpp"
+#include "MaquetteScene.hpp"
+#include "Maquette.hpp"
+
+#include <QThread>
+#include <QTimerEvent>
+#include <algorithm>
+#include <iostream>
+
+PlaybackClock::PlaybackClock(MaquetteScene *scene)
+  : QObject()
+{
+  _scene = scene;
+  _lastTick = 0;
+  _frameInterval = DEFAULT_FRAME_INTERVAL;
+  _lastPlayheadX = -1;
+  _renderedFrames = 0;
+  _skippedFrames = 0;
+  _droppedFrames = 0;
+}
+
+bool
+PlaybackClock::isActive() const
+{
+  return _timer.isActive();
+}
+
+void
+PlaybackClock::setFrameInterval(int interval)
+{
+  _frameInterval = std::max(1, interval);
+  if (_timer.isActive()) {
+      _timer.start(_frameInterval, this);
+    }
+}
+
+void
+PlaybackClock::start()
+{
+  if (QThread::currentThread() != thread()) {
+      QMetaObject::invokeMethod(this, "start", Qt::QueuedConnection);
+      return;
+    }
+
+  _renderedFrames = 0;
+  _skippedFrames = 0;
+  _droppedFrames = 0;
+  _lastPlayheadX = -1;
+  _clock.start();
+  _lastTick = 0;
+  _timer.start(_frameInterval, this);
+}
+
+void
+PlaybackClock::stop()
+{
+  if (QThread::currentThread() != thread()) {
+      QMetaObject::invokeMethod(this, "stop", Qt::QueuedConnection);
+      return;
+    }
+
+  if (_timer.isActive()) {
+      _timer.stop();
+#ifdef DEBUG
+      std::cerr << "PlaybackClock::stop : " << _renderedFrames << " frames rendered, "
+                << _skippedFrames << " skipped, " << _droppedFrames << " dropped" << std::endl;
+#endif
+    }
+}
+
+void
+PlaybackClock::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() != _timer.timerId()) {
+      QObject::timerEvent(event);
+      return;
+    }
+
+  // Handles Engines events once per frame, before the display is refreshed
+  Maquette::getInstance()->processEngineEvents();
+
+  if (!_scene->playing()) {
+      stop();
+      return;
+    }
+
+  // Ticks coming later than one frame mean frames were missed
+  qint64 now = _clock.elapsed();
+  qint64 late = now - _lastTick - _frameInterval;
+  if (late >= _frameInterval) {
+      _droppedFrames += late / _frameInterval;
+    }
+  _lastTick = now;
+
+  // Nothing to redraw while the play head stays on the same pixel
+  int playheadX = (int)(_scene->getCurrentTime() / MaquetteScene::MS_PER_PIXEL);
+  if (playheadX == _lastPlayheadX) {
+      _skippedFrames++;
+      return;
+    }
+  _lastPlayheadX = playheadX;
+
+  _scene->updatePlayingBoxes();
+  _scene->updateProgressBar();
+  _renderedFrames++;
+}
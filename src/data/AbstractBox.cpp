@@ -79,13 +79,11 @@ AbstractBox::type() const
 void
 AbstractBox::setStartMessages(NetworkMessages *startMsgs)
 {
-  QMap<QTreeWidgetItem *, Message> *map = startMsgs->getMessages();
-  NetworkMessages *newMessages = new NetworkMessages(map);
-  _startMessages = newMessages;
+  _startMessages = new NetworkMessages(startMsgs);
 }
 
 void
 AbstractBox::setEndMessages(NetworkMessages *endMsgs)
 {
-  _endMessages = new NetworkMessages(endMsgs->getMessages());
+  _endMessages = new NetworkMessages(endMsgs);
 }
@@ -0,0 +1,176 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file AddressTable.cpp
+ */
+
+#include "AddressTable.hpp"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include <iostream>
+
+using std::string;
+
+/*!
+ * \brief Structure containing an interned address.
+ */
+struct AddressEntry {
+  QString address;        //!< The address.
+  string stdAddress;      //!< The address as a std::string.
+  string device;          //!< The device of the address.
+  string path;            //!< The path of the address in its device.
+};
+
+/*
+ * Entries are stored in chunks of fixed size, allocated once and never moved
+ * nor modified once filled. The number of entries is published after an entry
+ * is filled : readers below this number need no lock. The lock only protects
+ * the addresses hash and the adding of entries.
+ */
+static const unsigned int CHUNK_SHIFT = 12;
+static const unsigned int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+static const unsigned int MAX_CHUNKS = 4096;
+
+static QReadWriteLock addressesLock;
+static QHash<QString, AddressID> addressesIDs;
+static AddressEntry *addressesChunks[MAX_CHUNKS];
+static QAtomicInt addressesCount(0);
+
+static const AddressEntry noEntry = AddressEntry();
+
+/*!
+ * \brief Gets the entry of an ID without lock, an empty one if the ID is not in the table.
+ */
+static inline const AddressEntry &
+entry(AddressID ID)
+{
+  if (ID >= (unsigned int)addressesCount.fetchAndAddAcquire(0)) {
+      return noEntry;
+    }
+  return addressesChunks[ID >> CHUNK_SHIFT][ID & (CHUNK_SIZE - 1)];
+}
+
+AddressID
+AddressTable::intern(const QString &address)
+{
+  {
+    QReadLocker locker(&addressesLock);
+    QHash<QString, AddressID>::const_iterator it = addressesIDs.find(address);
+    if (it != addressesIDs.end()) {
+        return it.value();
+      }
+  }
+
+  QWriteLocker locker(&addressesLock);
+  // Another thread may have added the address meanwhile
+  QHash<QString, AddressID>::const_iterator it = addressesIDs.find(address);
+  if (it != addressesIDs.end()) {
+      return it.value();
+    }
+
+  AddressID ID = (unsigned int)(int)addressesCount;
+  if ((ID >> CHUNK_SHIFT) >= MAX_CHUNKS) {
+      std::cerr << "AddressTable::intern : table full, address " << address.toStdString() << " ignored" << std::endl;
+      return NO_ADDRESS;
+    }
+  if ((ID & (CHUNK_SIZE - 1)) == 0) {
+      addressesChunks[ID >> CHUNK_SHIFT] = new AddressEntry[CHUNK_SIZE];
+    }
+
+  AddressEntry &newEntry = addressesChunks[ID >> CHUNK_SHIFT][ID & (CHUNK_SIZE - 1)];
+  newEntry.address = address;
+  newEntry.stdAddress = address.toStdString();
+  size_t pathBegin = newEntry.stdAddress.find('/');
+  if (pathBegin != string::npos) {
+      newEntry.device = newEntry.stdAddress.substr(0, pathBegin);
+      newEntry.path = newEntry.stdAddress.substr(pathBegin);
+    }
+  else {
+      newEntry.path = newEntry.stdAddress;
+    }
+  addressesIDs.insert(address, ID);
+
+  // Published once filled, so that readers never see a partial entry
+  addressesCount.fetchAndStoreRelease(ID + 1);
+
+  return ID;
+}
+
+AddressID
+AddressTable::intern(const string &address)
+{
+  return intern(QString::fromStdString(address));
+}
+
+AddressID
+AddressTable::find(const QString &address)
+{
+  QReadLocker locker(&addressesLock);
+  return addressesIDs.value(address, (AddressID)NO_ADDRESS);
+}
+
+const QString &
+AddressTable::address(AddressID ID)
+{
+  return entry(ID).address;
+}
+
+const string &
+AddressTable::stdAddress(AddressID ID)
+{
+  return entry(ID).stdAddress;
+}
+
+const string &
+AddressTable::device(AddressID ID)
+{
+  return entry(ID).device;
+}
+
+const string &
+AddressTable::path(AddressID ID)
+{
+  return entry(ID).path;
+}
+
+unsigned int
+AddressTable::size()
+{
+  return (unsigned int)addressesCount.fetchAndAddAcquire(0);
+}
@@ -1,10 +1,6 @@
 /*
  * Copyright: LaBRI / SCRIME
  *
- * Authors: Luc Vercellin (08/03/2010)
- *
- * luc.vercellin@labri.fr
- *
  * This software is a computer program whose purpose is to provide
  * notation/composition combining synthesized as well as recorded
  * sounds, providing answers to the problem of notation and, drawing,
@@ -38,36 +34,83 @@
  * knowledge of the CeCILL license and that you accept its terms.
  */
 
-
 /*!
- * \file PlayingThread.hpp
- *
- * \author Luc Vercellin
+ * \file EngineEventQueue.cpp
  */
 
-#include <QThread>
+#include "EngineEventQueue.hpp"
+
+EngineEventQueue::EngineEventQueue(unsigned int capacity)
+  : _head(0), _tail(0), _dropped(0), _finished(0)
+{
+  _capacity = 1;
+  while (_capacity < capacity) {
+      _capacity <<= 1;
+    }
+  _events = new EngineEvent[_capacity];
 
-class MaquetteScene;
+  // Indices wrap over twice the capacity so that a full queue differs from an empty one
+  _indexMask = 2 * _capacity - 1;
+}
 
-#ifndef PLAYINGTHREAD_H_
-#define PLAYINGTHREAD_H_
+EngineEventQueue::~EngineEventQueue()
+{
+  delete [] _events;
+}
 
-/*!
- * \class PlayingThread
- *
- * \brief Thread handling playing.
- */
-class PlayingThread : public QThread
+bool
+EngineEventQueue::push(const EngineEvent &event)
 {
+  // The end of the execution does not take a slot, so that a full queue can not lose it
+  if (event.type == EngineEvent::EXECUTION_FINISHED) {
+      _finished.fetchAndStoreRelease(1);
+      return true;
+    }
 
-  MaquetteScene *_scene;
+  int tail = _tail;
+  int head = _head.fetchAndAddAcquire(0);
 
-  public:
-    PlayingThread(MaquetteScene *scene);
+  if ((unsigned int)((tail - head) & _indexMask) == _capacity) {
+      _dropped.ref();
+      return false;
+    }
 
-  protected:
-    void run();
+  _events[tail & (_capacity - 1)] = event;
+  _tail.fetchAndStoreRelease((tail + 1) & _indexMask);
 
-};
+  return true;
+}
 
-#endif
+bool
+EngineEventQueue::takeExecutionFinished()
+{
+  return _finished.fetchAndStoreAcquire(0) != 0;
+}
+
+bool
+EngineEventQueue::pop(EngineEvent &event)
+{
+  int head = _head;
+  int tail = _tail.fetchAndAddAcquire(0);
+
+  if (head == tail) {
+      return false;
+    }
+
+  event = _events[head & (_capacity - 1)];
+  _head.fetchAndStoreRelease((head + 1) & _indexMask);
+
+  return true;
+}
+
+bool
+EngineEventQueue::isEmpty() const
+{
+  return const_cast<QAtomicInt&>(_head).fetchAndAddAcquire(0) == const_cast<QAtomicInt&>(_tail).fetchAndAddAcquire(0);
+}
+
+unsigned int
+EngineEventQueue::droppedEvents() const
+{
+  return (unsigned int)(int)_dropped;
+}
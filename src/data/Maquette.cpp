@@ -47,6 +47,7 @@
 #include "MainWindow.hpp"
 #include "MaquetteView.hpp"
 #include <QDomDocument>
+#include "ScoreFile.hpp"
 #include "ParentBox.hpp"
 #include "Engines.hpp"
 #include "AbstractRelation.hpp"
@@ -56,10 +57,22 @@
 #include <QTextStream>
 #include "AttributesEditor.hpp"
 #include "NetworkTree.hpp"
+#include "OSCBundle.hpp"
+#include "MessageValue.hpp"
+#include <QUdpSocket>
+#include <QHostAddress>
+#include <QHostInfo>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <QTimerEvent>
+#include <sys/time.h>
 
 #include <stdio.h>
+#include <ctype.h>
 #include <assert.h>
 #include <QCoreApplication>
+#include <QHash>
+#include <QSet>
 
 using std::vector;
 using std::map;
@@ -68,9 +81,9 @@ using std::stringstream;
 using std::list;
 using std::pair;
 
-typedef map<unsigned int, BasicBox*> BoxesMap;
-typedef map<unsigned int, Relation*> RelationsMap;
-typedef map<unsigned int, TriggerPoint*> TrgPntMap;
+typedef EntityStore<BasicBox*> BoxesMap;
+typedef EntityStore<Relation*> RelationsMap;
+typedef EntityStore<TriggerPoint*> TrgPntMap;
 
 #define SCENARIO_DURATION 1800000
 
@@ -185,6 +198,11 @@ Maquette::init()
 
 Maquette::Maquette()
 {
+  _parallelStateThreshold = PARALLEL_STATE_THRESHOLD;
+  _editDepth = 0;
+  _oscSocket = NULL;
+  _mutingStatesKnown = false;
+  _processingEngineEvents = false;
   //init();
 }
 
@@ -211,18 +229,7 @@ vector<unsigned int>
 Maquette::getRelationsIDs(unsigned int boxID)
 {
   vector<unsigned int> boxRelations;
-  RelationsMap::iterator rel;
-  unsigned int relID1 = NO_ID;
-  unsigned int relID2 = NO_ID;
-  for (rel = _relations.begin(); rel != _relations.end(); rel++) {
-      if (rel->first != NO_ID) {
-          relID1 = _engines->getRelationFirstBoxId(rel->first);
-          relID2 = _engines->getRelationSecondBoxId(rel->first);
-          if (boxID == relID1 || boxID == relID2) {
-              boxRelations.push_back(rel->first);
-            }
-        }
-    }
+  _relationIndex.boxRelations(boxID, boxRelations);
 
   return boxRelations;
 }
@@ -249,8 +256,8 @@ Maquette::getBox(unsigned int ID)
   return NULL;
 }
 
-map<unsigned int, ParentBox*>
-Maquette::parentBoxes()
+const EntityStore<ParentBox*> &
+Maquette::parentBoxes() const
 {
   return _parentBoxes;
 }
@@ -292,46 +299,80 @@ Maquette::addParentBox(unsigned int ID, const QPointF & corner1, const QPointF &
 
       newBox->setFirstMessagesToSend(firstMsgs);
       newBox->setLastMessagesToSend(lastMsgs);
+      invalidateBoxState(ID);
     }
 
   return ID;
 }
 
 unsigned int
-Maquette::addParentBox(unsigned int ID, const unsigned int date, const unsigned int topLeftY, const unsigned int sizeY, const unsigned int duration, const string & name, unsigned int mother, QColor color)
+Maquette::addParentBoxes(const vector<ScoreFile::Box> &boxes, vector<unsigned int> &IDs)
 {
-  QPointF corner1((date / MaquetteScene::MS_PER_PIXEL), topLeftY);
-  QPointF corner2((date + duration) / MaquetteScene::MS_PER_PIXEL, topLeftY + sizeY);
-  vector<string> firstMsgs;
-  vector<string> lastMsgs;
-  _engines->getCtrlPointMessagesToSend(ID, BEGIN_CONTROL_POINT_INDEX, firstMsgs);
-  _engines->getCtrlPointMessagesToSend(ID, END_CONTROL_POINT_INDEX, lastMsgs);
+  unsigned int unavailable = 0;
+  IDs.clear();
+  IDs.reserve(boxes.size());
+  _boxes.reserve(_boxes.size() + boxes.size());
+  _parentBoxes.reserve(_parentBoxes.size() + boxes.size());
 
-  ParentBox *newBox = new ParentBox(corner1, corner2, _scene);
+  // Messages of all boxes are fetched from the Engines before any graphical box is created
+  vector<vector<string> > firstMsgs(boxes.size());
+  vector<vector<string> > lastMsgs(boxes.size());
+  for (unsigned int i = 0; i < boxes.size(); ++i) {
+      if (boxes[i].type == "parent" && (unsigned int)boxes[i].ID != NO_ID) {
+          _engines->getCtrlPointMessagesToSend(boxes[i].ID, BEGIN_CONTROL_POINT_INDEX, firstMsgs[i]);
+          _engines->getCtrlPointMessagesToSend(boxes[i].ID, END_CONTROL_POINT_INDEX, lastMsgs[i]);
+        }
+    }
 
-  if (ID != NO_ID) {
-      newBox->setName(QString::fromStdString(name));
-      newBox->setColor(color);
+  for (unsigned int i = 0; i < boxes.size(); ++i) {
+      const ScoreFile::Box &box = boxes[i];
+      unsigned int ID = box.ID;
+      if (box.type == "unknown") {
+          continue;
+        }
+      if (box.type != "parent") {
+          unavailable++;
+          continue;
+        }
+      if (ID == NO_ID) {
+          continue;
+        }
+
+      QPointF corner1((box.begin / MaquetteScene::MS_PER_PIXEL), box.topLeftY);
+      QPointF corner2((box.begin + box.duration) / MaquetteScene::MS_PER_PIXEL, box.topLeftY + box.sizeY);
+      ParentBox *newBox = new ParentBox(corner1, corner2, _scene);
+      newBox->setName(box.name);
+      newBox->setColor(box.color);
       _boxes[ID] = newBox;
       _parentBoxes[ID] = newBox;
       newBox->setID(ID);
-      if (mother != NO_ID && mother != ROOT_BOX_ID) {
-          BoxesMap::iterator it;
-          if ((it = _boxes.find(mother)) != _boxes.end()) {
-              if (it->second->type() == PARENT_BOX_TYPE) {
-                  newBox->setMother(mother);
-                  static_cast<ParentBox*>(it->second)->addChild(ID);
-                }
-              else {
-                  newBox->setMother(ROOT_BOX_ID);
-                }
+      newBox->setFirstMessagesToSend(firstMsgs[i]);
+      newBox->setLastMessagesToSend(lastMsgs[i]);
+      invalidateBoxState(ID);
+      IDs.push_back(ID);
+    }
+
+  // Mothers are linked once every box exists, whatever the order of the boxes
+  for (unsigned int i = 0; i < boxes.size(); ++i) {
+      const ScoreFile::Box &box = boxes[i];
+      unsigned int mother = box.mother;
+      if (box.type != "parent" || (unsigned int)box.ID == NO_ID || mother == NO_ID || mother == ROOT_BOX_ID) {
+          continue;
+        }
+      BoxesMap::iterator it;
+      if ((it = _boxes.find(mother)) != _boxes.end()) {
+          BasicBox *newBox = _boxes[box.ID];
+          if (it->second->type() == PARENT_BOX_TYPE) {
+              newBox->setMother(mother);
+              static_cast<ParentBox*>(it->second)->addChild(box.ID);
+            }
+          else {
+              newBox->setMother(ROOT_BOX_ID);
             }
         }
-      newBox->setFirstMessagesToSend(firstMsgs);
-      newBox->setLastMessagesToSend(lastMsgs);
     }
 
-  return ID;
+  return unavailable;
 }
 
 /// \todo change arguments named corner. this is not comprehensible.
@@ -375,6 +416,7 @@ Maquette::addParentBox(const QPointF & corner1, const QPointF & corner2, const s
         }
       _engines->setCtrlPointMessagesToSend(newBoxID, BEGIN_CONTROL_POINT_INDEX, newBox->firstMessagesToSend());
       _engines->setCtrlPointMessagesToSend(newBoxID, END_CONTROL_POINT_INDEX, newBox->lastMessagesToSend());
+      invalidateBoxState(newBoxID);
     }
 
   return newBoxID;
@@ -450,6 +492,7 @@ Maquette::updateMessagesToSend(unsigned int boxID)
   if (boxID != NO_ID) {
       _engines->setCtrlPointMessagesToSend(boxID, BEGIN_CONTROL_POINT_INDEX, static_cast<ParentBox*>(_boxes[boxID])->firstMessagesToSend());
       _engines->setCtrlPointMessagesToSend(boxID, END_CONTROL_POINT_INDEX, static_cast<ParentBox*>(_boxes[boxID])->lastMessagesToSend());
+      invalidateBoxState(boxID);
       return true;
     }
   return false;
@@ -476,95 +519,87 @@ Maquette::lastMessagesToSend(unsigned int boxID)
 }
 
 
-void
-Maquette::updateCurves(unsigned int boxID, const vector<string> &startMsgs, const vector<string> &endMsgs)
+/*!
+ * Values of engine messages by address, parsed from their strings.
+ */
+static void
+valuesByAddress(const vector<string> &msgs, QHash<AddressID, MessageValue> &values)
 {
-  //QMap<address,value>
-  QMap<string, string> startMessages;
-  QMap<string, string> endMessages;
-  vector<string> curvesAddresses = getCurvesAddresses(boxID);
-
+  values.reserve(msgs.size());
   vector<string>::const_iterator it;
-  string currentMsg;
-  string currentAddress;
-  string currentValue;
-
-  /************  init start messages (QMap)  ************/
-  for (it = startMsgs.begin(); it != startMsgs.end(); ++it) {
-      size_t blankPos;
-      currentMsg = *it;
-      if ((blankPos = it->find_first_of(" ")) != string::npos) {
-          currentAddress = currentMsg.substr(0, blankPos);
-          if (blankPos != currentMsg.size()) {
-              currentValue = currentMsg.substr(blankPos + 1, currentMsg.size());
-            }
+  for (it = msgs.begin(); it != msgs.end(); ++it) {
+      size_t blankPos = it->find_first_of(" ");
+      if (blankPos != string::npos) {
+          values.insert(AddressTable::intern(it->substr(0, blankPos)), MessageValue::parse(it->substr(blankPos + 1)));
         }
-      startMessages.insert(currentAddress, currentValue);
     }
+}
 
-  /************  init end messages (QMap)  ************/
-  for (it = endMsgs.begin(); it != endMsgs.end(); ++it) {
-      size_t blankPos;
-      currentMsg = *it;
-      if ((blankPos = it->find_first_of(" ")) != string::npos) {
-          currentAddress = currentMsg.substr(0, blankPos);
-          if (blankPos != currentMsg.size()) {
-              currentValue = currentMsg.substr(blankPos + 1, currentMsg.size());
-            }
+/*!
+ * Values of box messages by address, as parsed when the messages were compiled.
+ */
+static void
+valuesByAddress(const NetworkMessages *messages, QHash<AddressID, MessageValue> &values)
+{
+  const QMap<AddressID, Message> &table = messages->table();
+  values.reserve(table.size());
+  QMap<AddressID, Message>::const_iterator it;
+  for (it = table.begin(); it != table.end(); ++it) {
+      if (!it->compiled.empty()) {
+          values.insert(it.key(), it->parsedValue);
         }
-      endMessages.insert(currentAddress, currentValue);
     }
+}
 
+void
+Maquette::updateCurves(unsigned int boxID, const QHash<AddressID, MessageValue> &startValues, const QHash<AddressID, MessageValue> &endValues)
+{
+  BasicBox *box = getBox(boxID);
+  if (box == NULL) {
+      return;
+    }
 
-  /************    Pour le cas open file   ************/
+  // Existing curves : kept and registered in the box for the case of an opened file
+  // while their address is sent at both ends, removed otherwise
+  vector<string> curvesAddresses = getCurvesAddresses(boxID);
+  QSet<AddressID> curves;
+  vector<AddressID> curvesToRemove;
+  vector<string>::const_iterator it;
   for (it = curvesAddresses.begin(); it != curvesAddresses.end(); ++it) {
-      currentMsg = *it;
-      getBox(boxID)->addCurveAddress(currentMsg);
-      if (startMessages.contains(currentMsg)) {
-          startMessages.remove(currentMsg);
+      AddressID address = AddressTable::intern(*it);
+      curves.insert(address);
+      if (startValues.contains(address) && endValues.contains(address)) {
+          box->addCurveAddress(address);
         }
-      if (endMessages.contains(currentMsg)) {
-          endMessages.remove(currentMsg);
+      else {
+          curvesToRemove.push_back(address);
         }
     }
 
-
-  /************  addCurve if endAddress contains startAddress && endValue != startValue ************/
-  QList<string> startAddresses = startMessages.keys();
-  QList<string>::iterator startAddressIt;
-
-  for (startAddressIt = startAddresses.begin(); startAddressIt != startAddresses.end(); ++startAddressIt) {
-      string address = *startAddressIt;
-      if (endMessages.contains(address)) {
-          if (std::find(curvesAddresses.begin(), curvesAddresses.end(), address) == curvesAddresses.end() && startMessages.value(address) != endMessages.value(address)) {
-              _engines->addCurve(boxID, address);
-              getBox(boxID)->addCurve(address);
-            }
+  // An address sent at both ends with different values gets a curve, values being compared on their types
+  vector<AddressID> curvesToAdd;
+  QHash<AddressID, MessageValue>::const_iterator endIt;
+  for (endIt = endValues.begin(); endIt != endValues.end(); ++endIt) {
+      if (curves.contains(endIt.key())) {
+          continue;
         }
-      else {
-          if (std::find(curvesAddresses.begin(), curvesAddresses.end(), address) != curvesAddresses.end()) {
-              _engines->removeCurve(boxID, address);
-            }
+      QHash<AddressID, MessageValue>::const_iterator startIt = startValues.find(endIt.key());
+      if (startIt != startValues.end() && *startIt != *endIt) {
+          curvesToAdd.push_back(endIt.key());
         }
     }
 
-  /************  addCurve if startAddress contains endAddress && endValue != startValue ************/
-  QList<string> endAddresses = endMessages.keys();
-  QList<string>::iterator endAddressIt;
+  vector<AddressID>::const_iterator addIt;
+  for (addIt = curvesToAdd.begin(); addIt != curvesToAdd.end(); ++addIt) {
+      _engines->addCurve(boxID, AddressTable::stdAddress(*addIt));
+      box->addCurveAddress(*addIt);
+    }
 
-  for (endAddressIt = endAddresses.begin(); endAddressIt != endAddresses.end(); ++endAddressIt) {
-      string address = *endAddressIt;
-      if (startMessages.contains(address)) {
-          if (std::find(curvesAddresses.begin(), curvesAddresses.end(), address) == curvesAddresses.end() && startMessages.value(address) != endMessages.value(address)) {
-              _engines->addCurve(boxID, address);
-              getBox(boxID)->addCurve(address);
-            }
-        }
-      else {
-          if (std::find(curvesAddresses.begin(), curvesAddresses.end(), address) != curvesAddresses.end()) {
-              _engines->removeCurve(boxID, address);
-            }
-        }
+  vector<AddressID>::const_iterator removeIt;
+  for (removeIt = curvesToRemove.begin(); removeIt != curvesToRemove.end(); ++removeIt) {
+      _engines->removeCurve(boxID, AddressTable::stdAddress(*removeIt));
+      box->removeCurve(*removeIt);
+      box->removeCurveAddress(*removeIt);
     }
 }
 
@@ -574,10 +609,14 @@ Maquette::setFirstMessagesToSend(unsigned int boxID, const vector<string> &first
   if (boxID != NO_ID && (getBox(boxID) != NULL)) {
       _engines->setCtrlPointMessagesToSend(boxID, BEGIN_CONTROL_POINT_INDEX, firstMsgs);
       _boxes[boxID]->setFirstMessagesToSend(firstMsgs);
+      invalidateBoxState(boxID);
 
       vector<string> lastMsgs;
       _engines->getCtrlPointMessagesToSend(boxID, END_CONTROL_POINT_INDEX, lastMsgs);
-      updateCurves(boxID, firstMsgs, lastMsgs);
+      QHash<AddressID, MessageValue> startValues, endValues;
+      valuesByAddress(firstMsgs, startValues);
+      valuesByAddress(lastMsgs, endValues);
+      updateCurves(boxID, startValues, endValues);
 
       return true;
     }
@@ -587,15 +626,27 @@ Maquette::setFirstMessagesToSend(unsigned int boxID, const vector<string> &first
 bool
 Maquette::setStartMessagesToSend(unsigned int boxID, NetworkMessages *messages)
 {
-  vector<string> firstMsgs = messages->computeMessages();
+  const vector<string> &firstMsgs = messages->computeMessages();
 
   if (boxID != NO_ID && (getBox(boxID) != NULL)) {
+      BasicBox *box = _boxes[boxID];
+      box->setStartMessages(messages);
+
+      // Messages already sent to the engine are not sent again
+      if (firstMsgs == box->firstMessagesToSend()) {
+          return true;
+        }
+
       _engines->setCtrlPointMessagesToSend(boxID, BEGIN_CONTROL_POINT_INDEX, firstMsgs);
-      _boxes[boxID]->setStartMessages(messages);
+      box->setFirstMessagesToSend(firstMsgs);
+      invalidateBoxState(boxID);
 
       vector<string> lastMsgs;
       _engines->getCtrlPointMessagesToSend(boxID, END_CONTROL_POINT_INDEX, lastMsgs);
-      updateCurves(boxID, firstMsgs, lastMsgs);
+      QHash<AddressID, MessageValue> startValues, endValues;
+      valuesByAddress(messages, startValues);
+      valuesByAddress(lastMsgs, endValues);
+      updateCurves(boxID, startValues, endValues);
 
       return true;
     }
@@ -663,6 +714,7 @@ Maquette::setStartMessages(unsigned int boxID, NetworkMessages* nm)
 {
   if (boxID != NO_ID && (getBox(boxID) != NULL)) {
       _boxes[boxID]->setStartMessages(nm);
+      invalidateBoxState(boxID);
       return true;
     }
   return false;
@@ -673,6 +725,7 @@ Maquette::setEndMessages(unsigned int boxID, NetworkMessages* nm)
 {
   if (boxID != NO_ID && (getBox(boxID) != NULL)) {
       _boxes[boxID]->setEndMessages(nm);
+      invalidateBoxState(boxID);
       return true;
     }
   return false;
@@ -696,10 +749,14 @@ Maquette::setLastMessagesToSend(unsigned int boxID, const vector<string> &lastMs
   if (boxID != NO_ID && (getBox(boxID) != NULL)) {
       _engines->setCtrlPointMessagesToSend(boxID, END_CONTROL_POINT_INDEX, lastMsgs);
       _boxes[boxID]->setLastMessagesToSend(lastMsgs);
+      invalidateBoxState(boxID);
 
       vector<string> firstMsgs;
       _engines->getCtrlPointMessagesToSend(boxID, BEGIN_CONTROL_POINT_INDEX, firstMsgs);
-      updateCurves(boxID, firstMsgs, lastMsgs);
+      QHash<AddressID, MessageValue> startValues, endValues;
+      valuesByAddress(firstMsgs, startValues);
+      valuesByAddress(lastMsgs, endValues);
+      updateCurves(boxID, startValues, endValues);
 
       return true;
     }
@@ -709,15 +766,27 @@ Maquette::setLastMessagesToSend(unsigned int boxID, const vector<string> &lastMs
 bool
 Maquette::setEndMessagesToSend(unsigned int boxID, NetworkMessages *messages)
 {
-  vector<string> lastMsgs = messages->computeMessages();
+  const vector<string> &lastMsgs = messages->computeMessages();
 
   if (boxID != NO_ID && (getBox(boxID) != NULL)) {
+      BasicBox *box = _boxes[boxID];
+      box->setEndMessages(messages);
+
+      // Messages already sent to the engine are not sent again
+      if (lastMsgs == box->lastMessagesToSend()) {
+          return true;
+        }
+
       _engines->setCtrlPointMessagesToSend(boxID, END_CONTROL_POINT_INDEX, lastMsgs);
-      _boxes[boxID]->setEndMessages(messages);
+      box->setLastMessagesToSend(lastMsgs);
+      invalidateBoxState(boxID);
 
       vector<string> firstMsgs;
       _engines->getCtrlPointMessagesToSend(boxID, BEGIN_CONTROL_POINT_INDEX, firstMsgs);
-      updateCurves(boxID, firstMsgs, lastMsgs);
+      QHash<AddressID, MessageValue> startValues, endValues;
+      valuesByAddress(firstMsgs, startValues);
+      valuesByAddress(messages, endValues);
+      updateCurves(boxID, startValues, endValues);
 
       return true;
     }
@@ -734,18 +803,128 @@ Maquette::sendMessage(const string &message)
   return false;
 }
 
+unsigned int
+Maquette::sendMessages(const vector<pair<AddressID, string> > &messages)
+{
+  map<string, OSCBundle> bundles;
+  unsigned int sent = 0;
+
+  if (_oscSocket == NULL) {
+      _oscSocket = new QUdpSocket(this);
+    }
+
+  for (vector<pair<AddressID, string> >::const_iterator it = messages.begin(); it != messages.end(); ++it) {
+      map<string, MyDevice>::iterator device = _devices.find(AddressTable::device(it->first));
+
+      if (device == _devices.end() || device->second.plugin != "OSC") {
+          if (sendMessage(AddressTable::stdAddress(it->first) + " " + it->second)) {
+              sent++;
+            }
+          continue;
+        }
+
+      const string &address = AddressTable::path(it->first);
+      const string &arguments = it->second;
+      OSCBundle &bundle = bundles[device->first];
+      if (!bundle.addMessage(address, arguments)) {
+          // Bundle full : sent before going on with a new one
+          if (sendOSCDatagram(bundle.data(), device->second)) {
+              sent++;
+            }
+          bundle.clear();
+          bundle.addMessage(address, arguments);
+        }
+    }
+
+  for (map<string, OSCBundle>::iterator it = bundles.begin(); it != bundles.end(); ++it) {
+      if (sendOSCDatagram(it->second.data(), _devices[it->first])) {
+          sent++;
+        }
+    }
+
+  return sent;
+}
+
+bool
+Maquette::sendOSCDatagram(const QByteArray &data, const MyDevice &device)
+{
+  map<string, QHostAddress>::iterator host = _oscHosts.find(device.networkHost);
+  if (host == _oscHosts.end()) {
+      resolveHost(device.networkHost);
+      host = _oscHosts.find(device.networkHost);
+    }
+
+  if (host == _oscHosts.end()) {
+      std::cerr << "Maquette::sendOSCDatagram : host " << device.networkHost << " of device " << device.name << " not resolved yet" << std::endl;
+      return false;
+    }
+  if (_oscSocket->writeDatagram(data, host->second, device.networkPort) != data.size()) {
+      std::cerr << "Maquette::sendOSCDatagram : sending to " << device.name << " failed : "
+                << _oscSocket->errorString().toStdString() << std::endl;
+      return false;
+    }
+  return true;
+}
+
+void
+Maquette::resolveHost(const string &host)
+{
+  QHostAddress address(QString::fromStdString(host));
+  if (!address.isNull()) {
+      _oscHosts[host] = address;
+      return;
+    }
+
+  map<int, string>::const_iterator it;
+  for (it = _hostLookups.begin(); it != _hostLookups.end(); ++it) {
+      if (it->second == host) {
+          return;
+        }
+    }
+  int lookupID = QHostInfo::lookupHost(QString::fromStdString(host), this, SLOT(hostResolved(QHostInfo)));
+  _hostLookups[lookupID] = host;
+}
+
+void
+Maquette::hostResolved(const QHostInfo &info)
+{
+  map<int, string>::iterator lookup = _hostLookups.find(info.lookupId());
+  if (lookup == _hostLookups.end()) {
+      return;
+    }
+  string host = lookup->second;
+  _hostLookups.erase(lookup);
+
+  // IPv4 addresses are preferred, devices mostly listening on them
+  QHostAddress address;
+  QList<QHostAddress> addresses = info.addresses();
+  for (int i = 0; i < addresses.size() && address.protocol() != QAbstractSocket::IPv4Protocol; ++i) {
+      address = addresses[i];
+    }
+
+  // A failure is not kept : the host is looked up again on the next sending
+  if (info.error() != QHostInfo::NoError || address.isNull()) {
+      std::cerr << "Maquette::hostResolved : unknown host " << host << " : " << info.errorString().toStdString() << std::endl;
+      return;
+    }
+  _oscHosts[host] = address;
+}
+
 void
 Maquette::clear()
 {
-  BoxesMap::iterator it;
-  for (it = _boxes.begin(); it != _boxes.end(); it++) {
-      removeBox(it->first);
+  // Removing an entity moves another one in its place : IDs are gathered first
+  vector<unsigned int> IDs;
+  _boxes.sortedIDs(IDs);
+  for (vector<unsigned int>::iterator it = IDs.begin(); it != IDs.end(); it++) {
+      removeBox(*it);
     }
-  RelationsMap::iterator it2;
-  for (it2 = _relations.begin(); it2 != _relations.end(); it2++) {
-      removeRelation(it2->first);
+  _relations.sortedIDs(IDs);
+  for (vector<unsigned int>::iterator it = IDs.begin(); it != IDs.end(); it++) {
+      removeRelation(*it);
     }
   _relations.clear();
+  _relationIndex.clear();
 }
 
 vector<unsigned int>
@@ -753,25 +932,18 @@ Maquette::removeBox(unsigned int boxID)
 {
   vector<unsigned int> removedRelations;
   if (boxID != NO_ID) {
-      RelationsMap::iterator it;
-      unsigned int relID = NO_ID;
-      for (it = _relations.begin(); it != _relations.end(); it++) {
-          relID = it->first;
-          if (relID != NO_ID) {
-              if (_engines->getRelationFirstBoxId(relID) == boxID
-                  || _engines->getRelationSecondBoxId(relID) == boxID) {
-                  removedRelations.push_back(relID);
-                }
-            }
-        }
+      _relationIndex.boxRelations(boxID, removedRelations);
 
       _engines->removeBox(boxID);
+      invalidateBoxState(boxID);
+      _mutedStarts.erase(boxID);
+      _mutedEnds.erase(boxID);
 
       BoxesMap::iterator it2 = _boxes.find(boxID);
       if (it2 != _boxes.end()) {
           _boxes.erase(it2);
         }
-      map<unsigned int, ParentBox*>::iterator it3 = _parentBoxes.find(boxID);
+      EntityStore<ParentBox*>::iterator it3 = _parentBoxes.find(boxID);
       if (it3 != _parentBoxes.end()) {
           _parentBoxes.erase(it3);
         }
@@ -790,7 +962,6 @@ Maquette::updateRelations()
 }
 
 
-/// \todo Duplication de code avec la méthode homonyme (surcharge)
 bool
 Maquette::updateBox(unsigned int boxID, const Coords &coord)
 {
@@ -799,8 +970,16 @@ Maquette::updateBox(unsigned int boxID, const Coords &coord)
   vector<unsigned int> moved;
   vector<unsigned int>::iterator it;
   int boxBeginTime;
+  if (_editDepth > 0) {
+      if (boxID == NO_ID || boxID == ROOT_BOX_ID || getBox(boxID) == NULL) {
+          return false;
+        }
+      _pendingEdits[boxID] = coord;
+      return true;
+    }
   if (boxID != NO_ID && boxID != ROOT_BOX_ID) {
       BasicBox *box = _boxes[boxID];
+      invalidateBoxState(boxID);
 
       if (moveAccepted = _engines->performBoxEditing(boxID, coord.topLeftX * MaquetteScene::MS_PER_PIXEL,
                                                      coord.topLeftX * MaquetteScene::MS_PER_PIXEL +
@@ -837,6 +1016,7 @@ Maquette::updateBox(unsigned int boxID, const Coords &coord)
 #ifdef DEBUG
           std::cerr << "Maquette::updateBoxes : box moved : " << *it << std::endl;
 #endif
+          invalidateBoxState(*it);
           if(_boxes[*it]->ID() != boxID){
           if ((_boxes[*it]->relativeBeginPos() != _engines->getBoxBeginTime(*it) / MaquetteScene::MS_PER_PIXEL ||
                (_engines->getBoxEndTime(*it) / MaquetteScene::MS_PER_PIXEL - _engines->getBoxBeginTime(*it) / MaquetteScene::MS_PER_PIXEL) != _boxes[*it]->width()) && _engines->getBoxBeginTime(*it)) {
@@ -862,54 +1042,86 @@ Maquette::updateBox(unsigned int boxID, const Coords &coord)
 bool
 Maquette::updateBoxes(const map<unsigned int, Coords> &boxes)
 {
-  bool moveAccepted;
-  vector<unsigned int> moved;
   map<unsigned int, Coords >::const_iterator it;
-  vector<unsigned int>::iterator it2;
+  beginEdit();
   for (it = boxes.begin(); it != boxes.end(); it++) {
-      if (it->first != NO_ID && it->first != ROOT_BOX_ID) {
-          BasicBox *curBox = _boxes[it->first];
-          if (moveAccepted = _engines->performBoxEditing(it->first, it->second.topLeftX * MaquetteScene::MS_PER_PIXEL,
-                                                         it->second.topLeftX * MaquetteScene::MS_PER_PIXEL +
-                                                         it->second.sizeX * MaquetteScene::MS_PER_PIXEL, moved)) {
-              curBox->setRelativeTopLeft(QPoint(it->second.topLeftX, it->second.topLeftY));
-              curBox->setSize(QPoint(it->second.sizeX, it->second.sizeY));
-              curBox->setPos(_boxes[it->first]->getCenter());
-              curBox->update();
-            }
-          else {
-              curBox->setRelativeTopLeft(QPoint(_engines->getBoxBeginTime(it->first) / MaquetteScene::MS_PER_PIXEL,
-                                                curBox->getTopLeft().y()));
-              curBox->setSize(QPoint((_engines->getBoxEndTime(it->first) / MaquetteScene::MS_PER_PIXEL -
-                                      _engines->getBoxBeginTime(it->first) / MaquetteScene::MS_PER_PIXEL),
-                                     curBox->getSize().y()));
-              curBox->setPos(curBox->getCenter());
-              curBox->update();
+      updateBox(it->first, it->second);
+    }
+  return commitEdit();
+}
+
+void
+Maquette::beginEdit()
+{
+  ++_editDepth;
+}
+
+bool
+Maquette::commitEdit()
+{
+  if (_editDepth == 0) {
+      std::cerr << "Maquette::commitEdit : no edit to commit" << std::endl;
+      return false;
+    }
+  if (--_editDepth > 0) {
+      return true;
+    }
+
+  map<unsigned int, Coords> edits;
+  edits.swap(_pendingEdits);
+
+  bool editAccepted = true;
+  std::set<unsigned int> movedBoxes;      // boxes to be read back from the engines
+  map<unsigned int, Coords>::const_iterator it;
+  for (it = edits.begin(); it != edits.end(); ++it) {
+      unsigned int boxID = it->first;
+      const Coords &coord = it->second;
+      unsigned int beginTime = coord.topLeftX * MaquetteScene::MS_PER_PIXEL;
+      unsigned int endTime = coord.topLeftX * MaquetteScene::MS_PER_PIXEL + coord.sizeX * MaquetteScene::MS_PER_PIXEL;
+      invalidateBoxState(boxID);
+
+      // A box already placed by the solving of another edited box needs no solving
+      if (_engines->getBoxBeginTime(boxID) == beginTime && _engines->getBoxEndTime(boxID) == endTime) {
+          movedBoxes.erase(boxID);
+          continue;
+        }
+
+      vector<unsigned int> moved;
+      if (_engines->performBoxEditing(boxID, beginTime, endTime, moved)) {
+          movedBoxes.insert(moved.begin(), moved.end());
+          movedBoxes.erase(boxID);
+        }
+      else {
+          editAccepted = false;
+          movedBoxes.insert(boxID);
 #ifdef DEBUG
-              std::cerr << "Maquette::updateBoxes : Move refused by Engines" << std::endl;
+          std::cerr << "Maquette::commitEdit : Move refused by Engines" << std::endl;
 #endif
-            }
         }
     }
 
-  if (moveAccepted) {
-      for (it2 = moved.begin(); it2 != moved.end(); it2++) {
-#ifdef DEBUG
-          std::cerr << "Maquette::updateBoxes : box moved : " << *it2 << std::endl;
-#endif
-          if (_boxes[*it2]->relativeBeginPos() != _engines->getBoxBeginTime(*it2) / MaquetteScene::MS_PER_PIXEL ||
-              (_engines->getBoxEndTime(*it2) / MaquetteScene::MS_PER_PIXEL - _engines->getBoxBeginTime(*it2) / MaquetteScene::MS_PER_PIXEL) != _boxes[*it2]->width()) {
-              _boxes[*it2]->setRelativeTopLeft(QPoint(_engines->getBoxBeginTime(*it2) / MaquetteScene::MS_PER_PIXEL,
-                                                      _boxes[*it2]->getTopLeft().y()));
-              _boxes[*it2]->setSize(QPoint((_engines->getBoxEndTime(*it2) / MaquetteScene::MS_PER_PIXEL -
-                                            _engines->getBoxBeginTime(*it2) / MaquetteScene::MS_PER_PIXEL),
-                                           _boxes[*it2]->getSize().y()));
-              _boxes[*it2]->setPos(_boxes[*it2]->getCenter());
-              _boxes[*it2]->update();
-            }
+  // Graphical items are only updated once all boxes are solved : dates of the moved boxes are read back from the engines
+  updateBoxesFromEngines(vector<unsigned int>(movedBoxes.begin(), movedBoxes.end()));
+
+  // Edited boxes keep the recorded vertical position and height, not handled by the engines,
+  // even when the solving of another box moved them afterwards
+  for (it = edits.begin(); it != edits.end(); ++it) {
+      BasicBox *box = _boxes[it->first];
+      const Coords &coord = it->second;
+      if (movedBoxes.find(it->first) == movedBoxes.end()) {
+          box->setRelativeTopLeft(QPoint((int)coord.topLeftX, (int)coord.topLeftY));
+          box->setSize(QPoint((int)coord.sizeX, (int)coord.sizeY));
+        }
+      else {
+          box->setRelativeTopLeft(QPoint(_engines->getBoxBeginTime(it->first) / MaquetteScene::MS_PER_PIXEL, (int)coord.topLeftY));
+          box->setSize(QPoint((_engines->getBoxEndTime(it->first) / MaquetteScene::MS_PER_PIXEL -
+                               _engines->getBoxBeginTime(it->first) / MaquetteScene::MS_PER_PIXEL), (int)coord.sizeY));
         }
+      box->setPos(box->getCenter());
+      box->update();
     }
-  return moveAccepted;
+
+  return editAccepted;
 }
 
 void
@@ -931,6 +1143,7 @@ Maquette::addTriggerPoint(const AbstractTriggerPoint &abstract)
 
       _triggerPoints[abstract.ID()] = newTP;
       _boxes[abstract.boxID()]->addTriggerPoint(abstract.boxExtremity(), newTP);
+      scheduleTriggerPoint(newTP);
       return (int)abstract.ID();
     }
   return RETURN_ERROR;
@@ -966,6 +1179,7 @@ Maquette::addTriggerPoint(unsigned int boxID, BoxExtremity extremity, const stri
       _scene->addItem(newTP);
       _triggerPoints[triggerID] = newTP;
       _boxes[boxID]->addTriggerPoint(extremity, _triggerPoints[triggerID]);
+      scheduleTriggerPoint(newTP);
 
       return triggerID;
     }
@@ -979,8 +1193,10 @@ Maquette::removeTriggerPoint(unsigned int ID)
   TrgPntMap::iterator it;
   if ((it = _triggerPoints.find(ID)) != _triggerPoints.end()) {
       _engines->removeTriggerPoint(ID);
+      _triggerSchedule.removeTrigger(ID);
+      TriggerPoint *trgPnt = it->second;
       _triggerPoints.erase(it);
-      delete it->second;
+      delete trgPnt;
     }
 }
 
@@ -1096,6 +1312,7 @@ Maquette::updateBoxesFromEngines(const vector<unsigned int> &movedBoxes)
   vector<unsigned int>::const_iterator it;
   if (!movedBoxes.empty()) {
       for (it = movedBoxes.begin(); it != movedBoxes.end(); it++) {
+          invalidateBoxState(*it);
           if ((_boxes[*it]->relativeBeginPos() != _engines->getBoxBeginTime(*it) / MaquetteScene::MS_PER_PIXEL ||
                (_engines->getBoxEndTime(*it) / MaquetteScene::MS_PER_PIXEL - _engines->getBoxBeginTime(*it) / MaquetteScene::MS_PER_PIXEL) != _boxes[*it]->width())) {
               _boxes[*it]->setRelativeTopLeft(QPoint(_engines->getBoxBeginTime(*it) / MaquetteScene::MS_PER_PIXEL,
@@ -1115,6 +1332,7 @@ Maquette::updateBoxesFromEngines()
 {
   BoxesMap::iterator it;
   for (it = _boxes.begin(); it != _boxes.end(); ++it) {
+      invalidateBoxState(it->first);
       it->second->setRelativeTopLeft(QPoint(_engines->getBoxBeginTime(it->first) / MaquetteScene::MS_PER_PIXEL,
                                             it->second->getTopLeft().y()));
       it->second->setSize(QPoint((_engines->getBoxEndTime(it->first) / MaquetteScene::MS_PER_PIXEL -
@@ -1165,6 +1383,8 @@ Maquette::addRelation(unsigned int ID1, BoxExtremity firstExtremum, unsigned int
   if (relationID != NO_ID) {
       Relation* newRel = new Relation(ID1, firstExtremum, ID2, secondExtremum, _scene);
       _relations[relationID] = newRel;
+      RelationEnds ends = { ID1, firstExtremum, ID2, secondExtremum };
+      _relationIndex.addRelation(relationID, ends);
 
       _boxes[ID1]->addRelation(firstExtremum, newRel);
       _boxes[ID2]->addRelation(secondExtremum, newRel);
@@ -1192,6 +1412,8 @@ Maquette::addRelation(const AbstractRelation &abstract)
       newRel->changeBounds(abstract.minBound(), abstract.maxBound());
 
       _relations[abstract.ID()] = newRel;
+      RelationEnds ends = { abstract.firstBox(), abstract.firstExtremity(), abstract.secondBox(), abstract.secondExtremity() };
+      _relationIndex.addRelation(abstract.ID(), ends);
       _scene->addItem(newRel);
       _boxes[abstract.firstBox()]->addRelation(abstract.firstExtremity(), newRel);
       _boxes[abstract.secondBox()]->addRelation(abstract.secondExtremity(), newRel);
@@ -1214,23 +1436,14 @@ Maquette::removeRelation(unsigned int relationID)
   if ((it = _relations.find(relationID)) != _relations.end()) {
       _engines->removeTemporalRelation(relationID);
       _relations.erase(it);
+      _relationIndex.removeRelation(relationID);
     }
 }
 
 bool
 Maquette::areRelated(unsigned int ID1, unsigned int ID2)
 {
-  RelationsMap::iterator rel;
-  unsigned int relID1 = NO_ID;
-  unsigned int relID2 = NO_ID;
-  for (rel = _relations.begin(); rel != _relations.end(); rel++) {
-      relID1 = _engines->getRelationFirstBoxId(rel->first);
-      relID2 = _engines->getRelationSecondBoxId(rel->first);
-      if ((relID1 == ID1 && relID2 == ID2) || (relID1 == ID2 && relID2 == ID1)) {
-          return true;
-        }
-    }
-  return false;
+  return _relationIndex.areRelated(ID1, ID2);
 }
 
 void
@@ -1285,350 +1498,478 @@ Maquette::setGotoValue(int gotoValue)
 void
 Maquette::generateTriggerQueue()
 {
+  updateTriggerSchedule();
   _scene->triggersQueueList()->clear();
-  TrgPntMap::iterator it1;
-  TriggerPoint *curTrg;
-  for (it1 = _triggerPoints.begin(); it1 != _triggerPoints.end(); ++it1) {
-      curTrg = it1->second;
-      if(curTrg->date()>=_engines->getGotoValue())
-        _scene->addToTriggerQueue(it1->second);
+
+  // Trigger points at or before the goto are already passed
+  vector<unsigned int> triggers;
+  _triggerSchedule.triggersAfter(_engines->getGotoValue(), triggers);
+  for (vector<unsigned int>::iterator it = triggers.begin(); it != triggers.end(); ++it) {
+      TriggerPoint *curTrg = getTriggerPoint(*it);
+      if (curTrg != NULL) {
+          _scene->triggersQueueList()->append(curTrg);
+        }
     }
 }
 
 void
-Maquette::initSceneState()
+Maquette::invalidateBoxState(unsigned int boxID)
 {
-  //Pour palier au bug du moteur (qui envoie tous les messages début et fin de toutes les boîtes < Goto)
-
-  double gotoValue = (double)_engines->getGotoValue();
-
-  unsigned int boxID;
-  QMap<QString, QPair<QString, unsigned int> > msgs, boxMsgs;
-  QList<QString> boxAddresses;
-  BasicBox *currentBox;
-  std::vector<string> curvesList;
-
-  //Pour toutes les boîtes avant le goto, on récupère leur état final (on simule leur exécution)
-  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
-      boxID = it->first;
-      currentBox = (*it).second;
-
-      //réinit : On démute toutes les boîtes, elles ont potentiellement pu être mutées à la fin de l'algo
-      _engines->setCtrlPointMutingState(boxID, 1, false);
-      _engines->setCtrlPointMutingState(boxID, 2, false);
-
-      if (currentBox->date() < gotoValue && (currentBox->date() + currentBox->duration()) <= gotoValue) {
-          boxMsgs = currentBox->getFinalState();
-        }
-      else if (gotoValue > currentBox->date() && gotoValue < (currentBox->date() + currentBox->duration())) {
-          //goto au milieu d'une boîte : On envoie la valeur du début de boîte
-          boxMsgs = currentBox->getStartState();
-          curvesList = _engines->getCurvesAddress(boxID);
-
-          //On supprime les messages si ils sont déjà associés à une courbe (le moteur les envoie automatiquement)
-          for (unsigned int i = 0; i < curvesList.size(); i++) {
-              //sauf si la courbe a été désactivée manuellement
-              if (!getCurveMuteState(boxID, curvesList[i])) {
-                  msgs.remove(QString::fromStdString(curvesList[i]));
-                }
-            }
-        }
-      else if (gotoValue == currentBox->date()) {
-          boxMsgs = currentBox->getStartState();
-        }
-      boxAddresses = boxMsgs.keys();
-
-      //Pour le cas où le même paramètre est modifié par plusieurs boîtes (avant le goto), on ne garde que la dernière modif.
-      for (QList<QString>::iterator it2 = boxAddresses.begin(); it2 != boxAddresses.end(); it2++) {
-          if (msgs.contains(*it2)) {
-              if (msgs.value(*it2).second < boxMsgs.value(*it2).second && boxMsgs.value(*it2).second <= gotoValue) {
-                  msgs.insert(*it2, boxMsgs.value(*it2));
-                }
-            }
-
-          //sinon on ajoute dans la liste de messages
-          else
-          if (boxMsgs.value(*it2).second <= gotoValue) {
-              msgs.insert(*it2, boxMsgs.value(*it2));
-            }
-        }
+  _timelineDirtyBoxes.insert(boxID);
+  _scheduleDirtyBoxes.insert(boxID);
 
-      //On mute tous les messages avant le goto (Bug du moteur, qui envoyait des valeurs non désirées)
-      //    Start messages
-      if (currentBox->date() < gotoValue) {
-          _engines->setCtrlPointMutingState(boxID, 1, true);
-        }
-
-      //    End messages
-      if (currentBox->date() + currentBox->duration() < gotoValue) {
-          _engines->setCtrlPointMutingState(boxID, 2, true);
+  // Children dates follow their mother
+  EntityStore<ParentBox*>::iterator it = _parentBoxes.find(boxID);
+  if (it != _parentBoxes.end()) {
+      const map<unsigned int, BasicBox*> &children = it->second->children();
+      for (map<unsigned int, BasicBox*>::const_iterator child = children.begin(); child != children.end(); ++child) {
+          invalidateBoxState(child->first);
         }
     }
+}
 
-  //traduction en QMap<QString,QString>, on supprime le champs date des messages
-  QList<QString> addresses = msgs.keys();
-
-  QString message;
-  for (QList<QString>::iterator it = addresses.begin(); it != addresses.end(); it++) {
-      message = *it + " " + msgs.value(*it).first;
-      sendMessage(message.toStdString());
+unsigned int
+Maquette::controlPointDate(unsigned int boxID, BoxExtremity extremity)
+{
+  // Engines dates are relative to the mother box
+  unsigned int date = (extremity == BOX_END) ? _engines->getBoxEndTime(boxID) : _engines->getBoxBeginTime(boxID);
+  BasicBox *box = getBox(boxID);
+  while (box != NULL && box->mother() != NO_ID && box->mother() != ROOT_BOX_ID) {
+      date += _engines->getBoxBeginTime(box->mother());
+      box = getBox(box->mother());
     }
+
+  return date;
 }
 
 void
-Maquette::pause()
+Maquette::scheduleTriggerPoint(TriggerPoint *trgPnt)
 {
-  _engines->pause(true);
+  _triggerSchedule.setTrigger(trgPnt->ID(), trgPnt->boxID(), controlPointDate(trgPnt->boxID(), trgPnt->boxExtremity()));
 }
 
 void
-Maquette::startPlaying()
-{
-  _engines->pause(false);
-  double gotoValue = (double)_engines->getGotoValue();
-  initSceneState();
-  generateTriggerQueue();
-  int nbTrg = _scene->triggersQueueList()->size();
-
-  try{
-      for (int i = 0; i < nbTrg; i++) {
-          if (gotoValue >= _scene->triggersQueueList()->first()->date()) {
-              _scene->triggersQueueList()->removeFirst();
+Maquette::updateTriggerSchedule()
+{
+  vector<unsigned int> triggers;
+  for (std::set<unsigned int>::iterator it = _scheduleDirtyBoxes.begin(); it != _scheduleDirtyBoxes.end(); ++it) {
+      triggers.clear();
+      _triggerSchedule.boxTriggers(*it, triggers);
+      for (vector<unsigned int>::iterator trgIt = triggers.begin(); trgIt != triggers.end(); ++trgIt) {
+          TriggerPoint *trgPnt = getTriggerPoint(*trgIt);
+          if (trgPnt != NULL && getBox(*it) != NULL) {
+              scheduleTriggerPoint(trgPnt);
             }
           else {
-              break;
+              _triggerSchedule.removeTrigger(*trgIt);
             }
         }
     }
-  catch (const std::exception & e) {
-      std::cerr << e.what();
-    }
+  _scheduleDirtyBoxes.clear();
+}
 
-  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
-      it->second->lock();
+unsigned int
+Maquette::triggerDate(unsigned int trgID)
+{
+  updateTriggerSchedule();
+  if (_triggerSchedule.contains(trgID)) {
+      return _triggerSchedule.date(trgID);
     }
-  _engines->play();
+
+  TriggerPoint *trgPnt = getTriggerPoint(trgID);
+  return trgPnt != NULL ? (unsigned int)trgPnt->date() : 0;
 }
 
 void
-Maquette::stopPlayingGotoStart()
+Maquette::setCheckpointInterval(unsigned int interval)
 {
-  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
-      it->second->unlock();
-    }
+  _timeline.setCheckpointInterval(interval);
+}
 
-  _engines->stop();
+unsigned int
+Maquette::checkpointsMemory() const
+{
+  return _timeline.checkpointsMemory();
+}
 
-  BoxesMap::iterator it;
-  for (it = _boxes.begin(); it != _boxes.end(); it++) {
-      int type = it->second->type();
-      if (type == PARENT_BOX_TYPE) {
-          static_cast<BasicBox*>(it->second)->setCrossedExtremity(BOX_END);
+void
+Maquette::updateTimeline()
+{
+  for (std::set<unsigned int>::iterator it = _timelineDirtyBoxes.begin(); it != _timelineDirtyBoxes.end(); ++it) {
+      BasicBox *box = getBox(*it);
+      if (box != NULL) {
+          _timeline.setBox(*it, box->date(), box->date() + box->duration(),
+                           box->startMessages()->values(), box->endMessages()->values());
+        }
+      else {
+          _timeline.removeBox(*it);
         }
     }
-  _scene->triggersQueueList()->clear();
-
-  setGotoValue(0);
+  _timelineDirtyBoxes.clear();
 }
 
 void
-Maquette::stopPlaying()
+Maquette::updateMutingStates(std::set<unsigned int> &muted, const vector<unsigned int> &toMute, unsigned int CPIndex)
 {
-  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
-      it->second->unlock();
-    }
-  _engines->stop();
+  std::set<unsigned int> newMuted(toMute.begin(), toMute.end());
+  std::set<unsigned int>::iterator it;
 
-  BoxesMap::iterator it;
-  for (it = _boxes.begin(); it != _boxes.end(); it++) {
-      int type = it->second->type();
-      if (type == PARENT_BOX_TYPE) {
-          static_cast<BasicBox*>(it->second)->setCrossedExtremity(BOX_END);
+  for (it = muted.begin(); it != muted.end(); ++it) {
+      if (newMuted.find(*it) == newMuted.end()) {
+          _engines->setCtrlPointMutingState(*it, CPIndex, false);
         }
     }
-  _scene->triggersQueueList()->clear();
+  for (it = newMuted.begin(); it != newMuted.end(); ++it) {
+      if (muted.find(*it) == muted.end()) {
+          _engines->setCtrlPointMutingState(*it, CPIndex, true);
+        }
+    }
+  muted.swap(newMuted);
 }
 
-void
-Maquette::stopPlayingWithGoto()
+/*!
+ * \brief Structure containing the data of a box needed to compute a scene state.
+ * Dates are taken from the boxes on the GUI thread, so that workers never read graphical objects.
+ * Messages tables are only read by the workers, the GUI thread waiting for them.
+ */
+struct BoxStateRecord {
+  unsigned int ID;                  //!< The box ID.
+  unsigned int begin;               //!< The box start date.
+  unsigned int end;                 //!< The box end date.
+  const NetworkMessages *startMsgs; //!< The start messages.
+  const NetworkMessages *endMsgs;   //!< The end messages.
+};
+
+/*!
+ * \brief Structure containing the scene state computed from a set of boxes.
+ */
+struct SceneStateChunk {
+  QMap<AddressID, TimelineWrite> state;    //!< The last write by address.
+  vector<unsigned int> playingBoxes;     //!< Boxes playing at the date.
+  vector<unsigned int> begunBoxes;       //!< Boxes begun before the date.
+  vector<unsigned int> endedBoxes;       //!< Boxes ended before the date.
+};
+
+/*!
+ * \brief Keeps a write in a state if it overrides the write already kept for its address.
+ */
+static void
+mergeWrite(QMap<AddressID, TimelineWrite> &state, AddressID address, const TimelineWrite &write)
 {
-  unsigned int gotoValue = _scene->getCurrentTime();
-  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
-      it->second->unlock();
+  QMap<AddressID, TimelineWrite>::iterator it = state.find(address);
+  if (it == state.end()) {
+      state.insert(address, write);
     }
-  _engines->stop();
-
-  BoxesMap::iterator it;
-  for (it = _boxes.begin(); it != _boxes.end(); it++) {
-      int type = it->second->type();
-      if (type == PARENT_BOX_TYPE) {
-          static_cast<BasicBox*>(it->second)->setCrossedExtremity(BOX_END);
-        }
+  else if (TimelineIndex::writeBefore(it.value(), write)) {
+      it.value() = write;
     }
-  _scene->triggersQueueList()->clear();
-  setGotoValue(gotoValue);
 }
 
-void
-Maquette::saveBox(unsigned int boxID)
-{
-  // TODO : handle others boxes further attributes during save
-  QString boxType = "unknown";
-  if (_boxes[boxID]->type() == PARENT_BOX_TYPE) {
-      boxType = QString("parent");
-    }
-  else {
-      boxType = QString("unknown");
-    }
+/*!
+ * \brief Computes the scene state at a date from a set of boxes, following the TimelineIndex rules.
+ */
+struct SceneStateMapper {
+  typedef SceneStateChunk result_type;
+
+  unsigned int date;
+
+  SceneStateMapper(unsigned int dateArg) : date(dateArg) {}
+
+  SceneStateChunk
+  operator()(const vector<BoxStateRecord> &boxes) const
+  {
+    SceneStateChunk chunk;
+    TimelineWrite write;
+    for (vector<BoxStateRecord>::const_iterator it = boxes.begin(); it != boxes.end(); ++it) {
+        unsigned int begin = it->begin;
+        unsigned int end = it->end;
+        write.boxID = it->ID;
+
+        if (begin <= date) {
+            write.date = begin;
+            write.end = false;
+            const QMap<AddressID, Message> &startMsgs = it->startMsgs->table();
+            for (QMap<AddressID, Message>::const_iterator msgIt = startMsgs.begin(); msgIt != startMsgs.end(); ++msgIt) {
+                write.value = msgIt->value;
+                mergeWrite(chunk.state, msgIt.key(), write);
+              }
+          }
+        if (begin < date && end <= date) {
+            write.date = end;
+            write.end = true;
+            const QMap<AddressID, Message> &endMsgs = it->endMsgs->table();
+            for (QMap<AddressID, Message>::const_iterator msgIt = endMsgs.begin(); msgIt != endMsgs.end(); ++msgIt) {
+                write.value = msgIt->value;
+                mergeWrite(chunk.state, msgIt.key(), write);
+              }
+          }
 
-  /* Provided for convenience */
-  BasicBox *box = _boxes[boxID];
-  unsigned int date = box->date();
-  unsigned int duration = box->duration();
-  unsigned int topLeftY = box->getTopLeft().y();
-  unsigned int sizeY = box->getSize().y();
-  QColor color = box->color();
-  QString name = box->name();
-  int mother = box->mother();
-  std::cout<<boxID<<" ISCORE begin : "<<date<<std::endl;
+        if (begin < date) {
+            chunk.begunBoxes.push_back(write.boxID);
+            if (end > date) {
+                chunk.playingBoxes.push_back(write.boxID);
+              }
+          }
+        if (end < date) {
+            chunk.endedBoxes.push_back(write.boxID);
+          }
+      }
+    return chunk;
+  }
+};
 
+static void
+reduceSceneState(SceneStateChunk &result, const SceneStateChunk &chunk)
+{
+  for (QMap<AddressID, TimelineWrite>::const_iterator it = chunk.state.begin(); it != chunk.state.end(); ++it) {
+      mergeWrite(result.state, it.key(), it.value());
+    }
+  result.playingBoxes.insert(result.playingBoxes.end(), chunk.playingBoxes.begin(), chunk.playingBoxes.end());
+  result.begunBoxes.insert(result.begunBoxes.end(), chunk.begunBoxes.begin(), chunk.begunBoxes.end());
+  result.endedBoxes.insert(result.endedBoxes.end(), chunk.endedBoxes.begin(), chunk.endedBoxes.end());
+}
 
-  // root node
-  QDomElement root = _doc->documentElement();
-  QDomElement boxNode = _doc->createElement("box");
-  root.firstChild().appendChild(boxNode);
+void
+Maquette::setParallelStateThreshold(unsigned int threshold)
+{
+  _parallelStateThreshold = threshold;
+}
 
-  boxNode.setAttribute("type", boxType);
-  boxNode.setAttribute("ID", boxID);
-  boxNode.setAttribute("name", name);
-  boxNode.setAttribute("mother", mother);
+void
+Maquette::initSceneState()
+{
+  //Pour palier au bug du moteur (qui envoie tous les messages début et fin de toutes les boîtes < Goto)
 
-  QDomElement positionNode = _doc->createElement("position");
+  unsigned int gotoValue = _engines->getGotoValue();
+  QMap<AddressID, TimelineWrite> msgs;
+  vector<unsigned int> playingBoxes, begunBoxes, endedBoxes;
+
+  if (_parallelStateThreshold != 0 && _boxes.size() >= _parallelStateThreshold) {
+      // Grande partition : l'état est reconstruit directement depuis les boîtes, par paquets sur tous les coeurs.
+      // L'index n'est pas utilisé ici : il n'est remis à jour que lorsqu'un goto le lit
+      unsigned int chunksCount = std::max(1, QThread::idealThreadCount() * 4);
+      unsigned int chunkSize = _boxes.size() / chunksCount + 1;
+      vector<vector<BoxStateRecord> > chunks;
+      BoxStateRecord record;
+      for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
+          if (chunks.empty() || chunks.back().size() >= chunkSize) {
+              chunks.push_back(vector<BoxStateRecord>());
+              chunks.back().reserve(chunkSize);
+            }
+          record.ID = it->second->ID();
+          record.begin = it->second->date();
+          record.end = record.begin + it->second->duration();
+          record.startMsgs = it->second->startMessages();
+          record.endMsgs = it->second->endMessages();
+          chunks.back().push_back(record);
+        }
 
-  QDomElement dateNode = _doc->createElement("date");
-  dateNode.setAttribute("begin", date);
-  dateNode.setAttribute("duration", duration);
+      SceneStateChunk sceneState = QtConcurrent::blockingMappedReduced<SceneStateChunk>(chunks, SceneStateMapper(gotoValue), reduceSceneState,
+                                                                                         QtConcurrent::UnorderedReduce);
+      msgs = sceneState.state;
+      playingBoxes.swap(sceneState.playingBoxes);
+      begunBoxes.swap(sceneState.begunBoxes);
+      endedBoxes.swap(sceneState.endedBoxes);
+    }
+  else {
+      updateTimeline();
 
-  QDomElement topLeftNode = _doc->createElement("top-left");
-  topLeftNode.setAttribute("y", topLeftY);
+      //Pour le cas où le même paramètre est modifié par plusieurs boîtes (avant le goto), on ne garde que la dernière modif.
+      _timeline.stateAt(gotoValue, msgs);
+#ifdef DEBUG
+      std::cerr << "Maquette::initSceneState : " << _timeline.checkpointsCount() << " checkpoints, "
+                << _timeline.checkpointsMemory() << " bytes" << std::endl;
+#endif
+      _timeline.boxesPlayingAt(gotoValue, playingBoxes);
+      _timeline.boxesBegunBefore(gotoValue, begunBoxes);
+      _timeline.boxesEndedBefore(gotoValue, endedBoxes);
+    }
 
-  QDomElement sizeNode = _doc->createElement("size");
-  sizeNode.setAttribute("y", sizeY);
+  //réinit : On démute toutes les boîtes, elles ont potentiellement pu être mutées par un état précédent du moteur
+  if (!_mutingStatesKnown) {
+      for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
+          _engines->setCtrlPointMutingState(it->first, 1, false);
+          _engines->setCtrlPointMutingState(it->first, 2, false);
+        }
+      _mutedStarts.clear();
+      _mutedEnds.clear();
+      _mutingStatesKnown = true;
+    }
 
-  positionNode.appendChild(dateNode);
-  positionNode.appendChild(topLeftNode);
-  positionNode.appendChild(sizeNode);
+  //goto au milieu d'une boîte : On envoie la valeur du début de boîte
+  for (vector<unsigned int>::iterator it = playingBoxes.begin(); it != playingBoxes.end(); ++it) {
+      vector<string> curvesList = _engines->getCurvesAddress(*it);
 
-  boxNode.appendChild(positionNode);
+      //On supprime les messages si ils sont déjà associés à une courbe (le moteur les envoie automatiquement)
+      for (unsigned int i = 0; i < curvesList.size(); i++) {
+          //sauf si la courbe a été désactivée manuellement
+          if (!getCurveMuteState(*it, curvesList[i])) {
+              QMap<AddressID, TimelineWrite>::iterator msgIt = msgs.find(AddressTable::intern(curvesList[i]));
+              if (msgIt != msgs.end() && msgIt.value().boxID == *it) {
+                  msgs.erase(msgIt);
+                }
+            }
+        }
+    }
 
-  QDomElement colorNode = _doc->createElement("color");
-  colorNode.setAttribute("red", color.red());
-  colorNode.setAttribute("green", color.green());
-  colorNode.setAttribute("blue", color.blue());
+  //On mute tous les messages avant le goto (Bug du moteur, qui envoyait des valeurs non désirées)
+  //Seules les boîtes dont l'état change sont modifiées dans le moteur
+  //    Start messages
+  updateMutingStates(_mutedStarts, begunBoxes, 1);
+  //    End messages
+  updateMutingStates(_mutedEnds, endedBoxes, 2);
 
-  boxNode.appendChild(colorNode);
+  //traduction en messages "adresse valeur", on supprime le champs date des messages
+  vector<pair<AddressID, string> > messages;
+  messages.reserve(msgs.size());
+  for (QMap<AddressID, TimelineWrite>::iterator it = msgs.begin(); it != msgs.end(); it++) {
+      messages.push_back(pair<AddressID, string>(it.key(), it.value().value.toStdString()));
+    }
+  sendMessages(messages);
+}
 
-  colorNode.setAttribute("red", color.red());
-  colorNode.setAttribute("green", color.green());
-  colorNode.setAttribute("blue", color.blue());
+void
+Maquette::pause()
+{
+  _engines->pause(true);
 }
 
-std::string
-Maquette::getNetworkHost()
+void
+Maquette::startPlaying()
 {
-  return _devices.at(_currentDevice).networkHost;
+  _engines->pause(false);
+  initSceneState();
+  generateTriggerQueue();
+
+  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
+      it->second->lock();
+    }
+  _engines->play();
 }
 
 void
-Maquette::save(const string &fileName)
+Maquette::stopPlayingGotoStart()
 {
-  _engines->store(fileName + ".simone");
+  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
+      it->second->unlock();
+    }
 
-  QFile file(QString::fromStdString(fileName));
+  _engines->stop();
 
-  if (!file.open(QFile::WriteOnly | QFile::Text)) {
-      _scene->displayMessage(((QString("Cannot write file %1:\n%2.")).arg(QString::fromStdString(fileName)).
-                              arg(file.errorString())).toStdString(), WARNING_LEVEL);
+  BoxesMap::iterator it;
+  for (it = _boxes.begin(); it != _boxes.end(); it++) {
+      int type = it->second->type();
+      if (type == PARENT_BOX_TYPE) {
+          static_cast<BasicBox*>(it->second)->setCrossedExtremity(BOX_END);
+        }
+    }
+  _scene->triggersQueueList()->clear();
 
-      //return false;
+  setGotoValue(0);
+}
+
+void
+Maquette::stopPlaying()
+{
+  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
+      it->second->unlock();
     }
+  _engines->stop();
 
-  QDomImplementation impl = QDomDocument().implementation();
+  BoxesMap::iterator it;
+  for (it = _boxes.begin(); it != _boxes.end(); it++) {
+      int type = it->second->type();
+      if (type == PARENT_BOX_TYPE) {
+          static_cast<BasicBox*>(it->second)->setCrossedExtremity(BOX_END);
+        }
+    }
+  _scene->triggersQueueList()->clear();
+}
 
-  QString publicId = "i-score 2012";
-  QString systemId = "http://scrime.labri.fr";
-  QString typeId = "i-scoreSave";
-  _doc = new QDomDocument(impl.createDocumentType(typeId, publicId, systemId));
+void
+Maquette::stopPlayingWithGoto()
+{
+  unsigned int gotoValue = _scene->getCurrentTime();
+  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); it++) {
+      it->second->unlock();
+    }
+  _engines->stop();
 
-  QDomElement root = _doc->createElement("GRAPHICS");
-  root.setAttribute("zoom", _scene->zoom());
-  root.setAttribute("centerX", _scene->view()->getCenterCoordinates().x());
-  root.setAttribute("centerY", _scene->view()->getCenterCoordinates().y());
-  _doc->appendChild(root);
+  BoxesMap::iterator it;
+  for (it = _boxes.begin(); it != _boxes.end(); it++) {
+      int type = it->second->type();
+      if (type == PARENT_BOX_TYPE) {
+          static_cast<BasicBox*>(it->second)->setCrossedExtremity(BOX_END);
+        }
+    }
+  _scene->triggersQueueList()->clear();
+  setGotoValue(gotoValue);
+}
 
-  QDomElement boxesNode = _doc->createElement("boxes");
-  root.appendChild(boxesNode);
+std::string
+Maquette::getNetworkHost()
+{
+  return _devices.at(_currentDevice).networkHost;
+}
 
-  for (BoxesMap::iterator it = _boxes.begin(); it != _boxes.end(); ++it) {
-      saveBox(it->first);
+void
+Maquette::save(const string &fileName)
+{
+  // Renamed beside the score by ScoreFile::write, once both are written
+  string enginesTempName = fileName + ".simone.tmp";
+  _engines->store(enginesTempName);
+
+  ScoreFile score;
+  score.zoom = _scene->zoom();
+  score.center = _scene->view()->getCenterCoordinates();
+
+  vector<unsigned int> boxesIDs;
+  _boxes.sortedIDs(boxesIDs);
+  score.boxes.reserve(boxesIDs.size());
+  for (vector<unsigned int>::iterator it = boxesIDs.begin(); it != boxesIDs.end(); ++it) {
+      // TODO : handle others boxes further attributes during save
+      BasicBox *box = _boxes[*it];
+      ScoreFile::Box savedBox;
+      savedBox.ID = *it;
+      savedBox.type = box->type() == PARENT_BOX_TYPE ? QString("parent") : QString("unknown");
+      savedBox.name = box->name();
+      savedBox.mother = box->mother();
+      savedBox.begin = box->date();
+      savedBox.duration = box->duration();
+      savedBox.topLeftY = box->getTopLeft().y();
+      savedBox.sizeY = box->getSize().y();
+      savedBox.color = box->color();
+      score.boxes.push_back(savedBox);
     }
 
   //****************************  Devices ****************************
-  QDomElement devicesNode = _doc->createElement("Devices");
-  QDomElement deviceNode;
-
   std::map<std::string, MyDevice>::iterator it;
-  string deviceName;
-  unsigned int networkPort;
-  string networkHost;
-  string plugin;
-  MyDevice curDevice;
-
   for (it = _devices.begin(); it != _devices.end(); it++) {
-      curDevice = it->second;
-
-      deviceName = curDevice.name;
-      networkPort = curDevice.networkPort;
-      networkHost = curDevice.networkHost;
-      plugin = curDevice.plugin;
-
-      deviceNode = _doc->createElement("Device");
-      deviceNode.setAttribute("IP", QString::fromStdString(networkHost));
-      deviceNode.setAttribute("port", networkPort);
-      deviceNode.setAttribute("plugin", QString::fromStdString(plugin));
-      deviceNode.setAttribute("name", QString::fromStdString(deviceName));
-
-      devicesNode.appendChild(deviceNode);
+      const MyDevice &curDevice = it->second;
+      ScoreFile::Device savedDevice;
+      savedDevice.name = QString::fromStdString(curDevice.name);
+      savedDevice.ip = QString::fromStdString(curDevice.networkHost);
+      savedDevice.port = QString::number(curDevice.networkPort);
+      savedDevice.plugin = QString::fromStdString(curDevice.plugin);
+      score.devices.push_back(savedDevice);
     }
 
-  root.appendChild(devicesNode);
-
   //OSC Messages
-  QList<QString> OSCMessages = _scene->editor()->networkTree()->getOSCMessages();
-
-  QDomElement OSCMessagesNode = _doc->createElement("OSCMessages");
-  QDomElement OSCMessageNode;
-
-  for (QList<QString>::iterator it = OSCMessages.begin(); it != OSCMessages.end(); it++) {
-      OSCMessageNode = _doc->createElement("OSC");
-      OSCMessageNode.setAttribute("message", *it);
-      OSCMessagesNode.appendChild(OSCMessageNode);
-    }
-  root.appendChild(OSCMessagesNode);
+  score.OSCMessages = _scene->editor()->networkTree()->getOSCMessages();
 
   //***************************************************************
 
-  QTextStream ts(&file);
-  ts << _doc->toString();
-  file.close();
-
-  delete _doc;
+  if (!score.write(QString::fromStdString(fileName), QString::fromStdString(enginesTempName))) {
+      _scene->displayMessage(((QString("Cannot write file %1:\n%2.")).arg(QString::fromStdString(fileName)).
+                              arg(score.errorString())).toStdString(), WARNING_LEVEL);
+    }
 }
 
 void
 Maquette::loadOLD(const string &fileName)
 {
   _engines->load(fileName + ".simone");
+  _mutingStatesKnown = false;
   _engines->addCrossingCtrlPointCallback(&crossTransitionCallback);
   _engines->addExecutionFinishedCallback(&executionFinishedCallback);
 
@@ -1856,35 +2197,18 @@ void
 Maquette::load(const string &fileName)
 {
   _engines->load(fileName + ".simone");
+  _mutingStatesKnown = false;
   _engines->addCrossingCtrlPointCallback(&crossTransitionCallback);
   _engines->addExecutionFinishedCallback(&executionFinishedCallback);
 
+  QString scoreName = QString::fromStdString(fileName);
   QFile enginesFile(QString::fromStdString(fileName + ".simone"));
-  QFile file(QString::fromStdString(fileName));
 
-  _doc = new QDomDocument;
-
-  if (enginesFile.open(QFile::ReadOnly)) {
-      if (!file.open(QFile::ReadOnly | QFile::Text)) {
-          _scene->displayMessage((tr("Cannot read file %1:\n%2.")
-                                  .arg(QString::fromStdString(fileName))
-                                  .arg(file.errorString())).toStdString(),
-                                 WARNING_LEVEL);
-          return;
-        }
-      else if (!_doc->setContent(&file)) {
-          _scene->displayMessage((tr("Cannot import xml document from %1:\n%2.")
-                                  .arg(QString::fromStdString(fileName))
-                                  .arg(file.errorString())).toStdString(),
-                                 WARNING_LEVEL);
-          file.close();
-          return;
-        }
-    }
-  else {
-      if (!file.open(QFile::ReadOnly | QFile::Text)) {
+  if (!enginesFile.open(QFile::ReadOnly)) {
+      QFile file(scoreName);
+      if (!file.open(QFile::ReadOnly)) {
           _scene->displayMessage((tr("Cannot read neither file %1 or %2 :\n%3.")
-                                  .arg(QString::fromStdString(fileName))
+                                  .arg(scoreName)
                                   .arg(QString::fromStdString(fileName + ".simone"))
                                   .arg(file.errorString())).toStdString(),
                                  WARNING_LEVEL);
@@ -1892,107 +2216,64 @@ Maquette::load(const string &fileName)
       else {
           _scene->displayMessage((tr("Cannot read file %1 :\n%2.")
                                   .arg(QString::fromStdString(fileName + ".simone"))
-                                  .arg(file.errorString())).toStdString(),
+                                  .arg(enginesFile.errorString())).toStdString(),
                                  WARNING_LEVEL);
         }
-    }
-
-  if (_doc->doctype().nodeName() != "i-scoreSave") {
       loadOLD(fileName);
       return;
     }
+  enginesFile.close();
 
-  QDomElement root = _doc->documentElement();
+  // The boxes are known by the Engines before the score is read
+  vector<unsigned int> boxesID;
+  _engines->getBoxesId(boxesID);
 
-  if (root.tagName() != "GRAPHICS") {
-      _scene->displayMessage((tr("Unvailable xml document %1").
-                              arg(QString::fromStdString(fileName))).toStdString(),
-                             WARNING_LEVEL);
-      file.close();
-      return;
-    }
+  ScoreFile score;
+  switch (score.read(scoreName, boxesID.size())) {
+      case ScoreFile::READ_OK:
+        break;
 
-  _scene->clear();
+      case ScoreFile::NOT_A_SCORE:
+        loadOLD(fileName);
+        return;
 
-  QPointF topLeft, size, bottomRight;
-  unsigned int begin, duration, topLeftY, sizeY;
-  QString name, boxType;
-  QColor color(1., 1., 1.);
-  int boxID, motherID;
-  float zoom;
-  QPointF centerCoordinates;
+      case ScoreFile::OPEN_ERROR:
+        _scene->displayMessage((tr("Cannot read file %1:\n%2.")
+                                .arg(scoreName)
+                                .arg(score.errorString())).toStdString(),
+                               WARNING_LEVEL);
+        return;
+
+      case ScoreFile::INVALID_ROOT:
+        _scene->displayMessage((tr("Unvailable xml document %1").
+                                arg(scoreName)).toStdString(),
+                               WARNING_LEVEL);
+        return;
+
+      default:
+        _scene->displayMessage((tr("Cannot import xml document from %1:\n%2.")
+                                .arg(scoreName)
+                                .arg(score.errorString())).toStdString(),
+                               WARNING_LEVEL);
+        return;
+    }
 
-  zoom = root.attribute("zoom", "1").toFloat();
-  centerCoordinates = QPointF(root.attribute("centerX", "0.").toFloat(), root.attribute("centerY", "0.").toFloat());
+  float zoom = score.zoom;
+
+  /************************ BOXES ************************/
+  _scene->clear();
 
   _scene->view()->setZoom(zoom);
-  _scene->view()->centerOn(centerCoordinates);
+  _scene->view()->centerOn(score.center);
 
-  QDomNode mainNode = root.firstChild();      // Boxes
-  while (!mainNode.isNull()) {
-      QDomNode node1 = mainNode.firstChild(); // Box
-      while (!node1.isNull()) {
-          QDomElement elt1 = node1.toElement();
-          if (!elt1.isNull()) {
-              if (elt1.tagName() == "box") {
-                  boxID = elt1.attribute("ID", QString("%1").arg(NO_ID)).toInt();
-                  boxType = elt1.attribute("type", "unknown");
-                  name = elt1.attribute("name", "unknown");
-                  motherID = elt1.attribute("mother", QString("%1").arg(ROOT_BOX_ID)).toInt();
-                }
-              QDomNode node2 = node1.firstChild();
-              while (!node2.isNull()) {
-                  QDomElement elt2 = node2.toElement();
-                  if (!elt2.isNull()) {
-                      if (elt2.tagName() == "color") {
-                          color = QColor(elt2.attribute("red", "1").toInt(), elt2.attribute("green", "1").toInt(),
-                                         elt2.attribute("blue", "1").toInt());
-                        }
-                      QDomNode node3 = node2.firstChild();
-                      while (!node3.isNull()) {
-                          QDomElement elt3 = node3.toElement();
-                          if (elt2.tagName() == "position") {
-                              if (elt3.tagName() == "date") {
-                                  begin = elt3.attribute("begin", "0").toInt();
-                                  duration = elt3.attribute("duration", "0").toInt();
-                                }
-                              else if (elt3.tagName() == "top-left") {
-                                  topLeftY = sizeY = elt3.attribute("y", "0").toInt();
-                                }
-                              else if (elt3.tagName() == "size") {
-                                  sizeY = elt3.attribute("y", "0").toInt();
-                                }
-                            }
-                          node3 = node3.nextSibling();
-                        }
-                    }
-                  node2 = node2.nextSibling();
-                }
-            }
-          if (!elt1.isNull()) {
-              if (elt1.tagName() == "box") {
-                  if (boxType != "unknown") {
-                      bottomRight = topLeft + size;
-                      unsigned int ID = NO_ID;
-                      if (boxType == "parent") {
-                          ID = addParentBox((unsigned int)boxID, (unsigned int)begin, (unsigned int)topLeftY, (unsigned int)sizeY, (unsigned int)duration, name.toStdString(), motherID, color);
-                          _scene->addParentBox(ID);
-                        }
-                      else {
-                          _scene->displayMessage((QString("Unavailable box type through loading %1")
-                                                  .arg(QString::fromStdString(fileName))).toStdString(),
-                                                 WARNING_LEVEL);
-                        }
-                    }
-                }
-            }
-          node1 = node1.nextSibling();   // next Box
-        }
-      mainNode = mainNode.nextSibling();
+  vector<unsigned int> loadedIDs;
+  if (addParentBoxes(score.boxes, loadedIDs) != 0) {
+      _scene->displayMessage((QString("Unavailable box type through loading %1")
+                              .arg(scoreName)).toStdString(),
+                             WARNING_LEVEL);
     }
+  _scene->addParentBoxes(loadedIDs);
 
-  vector<unsigned int> boxesID;
-  _engines->getBoxesId(boxesID);
   vector<unsigned int>::iterator it;
 
   /************************ TRIGGER ************************/
@@ -2107,40 +2388,23 @@ Maquette::load(const string &fileName)
     }
   _devices.clear();
 
-  //read from xml
-  if (root.childNodes().size() >= 2) { //Devices
-      QDomElement devices = root.childNodes().at(1).toElement();
-      if (devices.tagName() != "Devices") {
-          _scene->displayMessage((tr("Unvailable xml document %1 - Devices problem").
-                                  arg(QString::fromStdString(fileName))).toStdString(),
-                                 WARNING_LEVEL);
-          file.close();
-          return;
-        }
-      else {  //get device infos
-          QString deviceName;
-          QString ip;
-          QString port;
-          QString plugin;
-
-          for (int i = 0; i < devices.childNodes().size(); i++) { //Device
-              if (devices.childNodes().at(i).toElement().tagName() == "Device") {
-                  deviceName = devices.childNodes().at(i).toElement().attribute("name");
-                  ip = devices.childNodes().at(i).toElement().attribute("IP");
-                  port = devices.childNodes().at(i).toElement().attribute("port");
-                  plugin = devices.childNodes().at(i).toElement().attribute("plugin");
-
-                  addNetworkDevice(deviceName.toStdString(), plugin.toStdString(), ip.toStdString(), port.toStdString());
-
-                  //save OSC device (for OSCMessages)
-                  if (plugin == "OSC") {
-                      OSCDevice.name = deviceName.toStdString();
-                      OSCDevice.networkHost = ip.toStdString();
-                      OSCDevicePort = port.toStdString();
-                      OSCDevice.plugin = plugin.toStdString();
-                    }
-                }
-            }
+  //read from the score
+  if (score.devicesState == ScoreFile::PART_MISPLACED) {
+      _scene->displayMessage((tr("Unvailable xml document %1 - Devices problem").
+                              arg(scoreName)).toStdString(),
+                             WARNING_LEVEL);
+      return;
+    }
+  vector<ScoreFile::Device>::const_iterator deviceIt;
+  for (deviceIt = score.devices.begin(); deviceIt != score.devices.end(); ++deviceIt) {
+      addNetworkDevice(deviceIt->name.toStdString(), deviceIt->plugin.toStdString(), deviceIt->ip.toStdString(), deviceIt->port.toStdString());
+
+      //save OSC device (for OSCMessages)
+      if (deviceIt->plugin == "OSC") {
+          OSCDevice.name = deviceIt->name.toStdString();
+          OSCDevice.networkHost = deviceIt->ip.toStdString();
+          OSCDevicePort = deviceIt->port.toStdString();
+          OSCDevice.plugin = deviceIt->plugin.toStdString();
         }
     }
 
@@ -2148,29 +2412,16 @@ Maquette::load(const string &fileName)
   _scene->editor()->networkTree()->load();
 
   /************************ OSC ************************/
-  if (root.childNodes().size() >= 2) {
-      QDomElement OSC = root.childNodes().at(2).toElement();
-
-      if (OSC.tagName() != "OSCMessages") {
-          _scene->displayMessage((tr("Unvailable xml document %1 - OSC Messages problem").
-                                  arg(QString::fromStdString(fileName))).toStdString(),
-                                 WARNING_LEVEL);
-          file.close();
-          return;
-        }
-
-      QList<QString> OSCMessagesList;
-      for (int i = 0; i < OSC.childNodes().size(); i++) {
-          if (OSC.childNodes().at(i).toElement().tagName() == "OSC") {
-              OSCMessagesList << OSC.childNodes().at(i).toElement().attribute("message");
-            }
-        }
-
+  if (score.OSCMessagesState == ScoreFile::PART_MISPLACED) {
+      _scene->displayMessage((tr("Unvailable xml document %1 - OSC Messages problem").
+                              arg(scoreName)).toStdString(),
+                             WARNING_LEVEL);
+      return;
+    }
+  if (score.OSCMessagesState == ScoreFile::PART_PRESENT) {
       _scene->setNetworDeviceConfig(OSCDevice.name, OSCDevice.plugin, OSCDevice.networkHost, OSCDevicePort);
-      _scene->editor()->networkTree()->createItemsFromMessages(OSCMessagesList);
+      _scene->editor()->networkTree()->createItemsFromMessages(score.OSCMessages);
     }
-
-  delete _doc;
 }
 
 void
@@ -2183,6 +2434,9 @@ Maquette::addNetworkDevice(string deviceName, string plugin, string ip, string p
   MyDevice newDevice(deviceName, plugin, portInt, ip);
   _devices[deviceName] = newDevice;
   _engines->addNetworkDevice(deviceName, plugin, ip, port);
+
+  // Looked up now, so that states are not delayed by the host resolution
+  resolveHost(ip);
 }
 
 double
@@ -2200,8 +2454,8 @@ Maquette::setAccelerationFactor(const float &factor)
 void
 Maquette::crossedTransition(unsigned int boxID, unsigned int CPIndex)
 {
-  int type = getBox(boxID)->type();
-  if (type == PARENT_BOX_TYPE) {
+  BasicBox *box = getBox(boxID);
+  if (box != NULL && box->type() == PARENT_BOX_TYPE) {
       if (CPIndex == BEGIN_CONTROL_POINT_INDEX) {
           static_cast<BasicBox*>(_boxes[boxID])->setCrossedExtremity(BOX_START);
         }
@@ -2244,62 +2498,308 @@ Maquette::executionFinished()
   _scene->timeEndReached();
 }
 
-void
-crossTransitionCallback(unsigned int boxID, unsigned int CPIndex, vector<unsigned int> processesToStop)
+/*!
+ * \brief Structure associating a transport address with its command.
+ */
+struct TransportCommandEntry {
+  const std::string *address;   //!< The transport address.
+  EngineEvent::Command command; //!< The command dispatched.
+  unsigned int argsCount;       //!< The number of mandatory arguments.
+};
+
+//! Transport commands, sorted by address.
+static const TransportCommandEntry TRANSPORT_COMMANDS[] = {
+  { &NEXT_TRIGGER_MESSAGE, EngineEvent::NEXT_TRIGGER, 0 },
+  { &PLAY_ENGINES_MESSAGE, EngineEvent::PLAY, 0 },
+  { &REWIND_ENGINES_MESSAGE, EngineEvent::REWIND, 0 },
+  { &SPEED_ENGINES_MESSAGE, EngineEvent::SPEED, 1 },
+  { &STARTPOINT_ENGINES_MESSAGE, EngineEvent::START_POINT, 1 },
+  { &STOP_ENGINES_MESSAGE, EngineEvent::STOP, 0 }
+};
+
+static const unsigned int TRANSPORT_COMMANDS_COUNT = sizeof(TRANSPORT_COMMANDS) / sizeof(TransportCommandEntry);
+
+//! Seconds between the NTP epoch (1900) and the Unix epoch (1970).
+static const qint64 NTP_UNIX_OFFSET = 2208988800LL;
+
+static bool
+transportAddressBefore(const TransportCommandEntry &entry, const string &address)
 {
-  Maquette::getInstance()->crossedTransition(boxID, CPIndex);
-  for (vector<unsigned int>::iterator it = processesToStop.begin(); it != processesToStop.end(); ++it) {
-      Maquette::getInstance()->crossedTransition(*it, END_CONTROL_POINT_INDEX);
+  return *entry.address < address;
+}
+
+/*!
+ * \brief Gets the current time.
+ *
+ * \return the time in us since the epoch
+ */
+static qint64
+currentMicroseconds()
+{
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (qint64)now.tv_sec * 1000000 + now.tv_usec;
+}
+
+/*!
+ * \brief Parses an integer argument followed by a blank or the end of the arguments.
+ *
+ * \param args : the arguments, moved after the integer when parsed
+ * \param value : the integer parsed
+ * \return false if the next argument is not an integer
+ */
+static bool
+parseIntegerArgument(const char *&args, unsigned long &value)
+{
+  char *argEnd = NULL;
+  value = strtoul(args, &argEnd, 10);
+  if (argEnd == args || (*argEnd != '\0' && !isspace(*argEnd))) {
+      return false;
+    }
+  args = argEnd;
+  return true;
+}
+
+/*!
+ * \brief Parses a transport message received from the network into a command.
+ * Mandatory arguments can be followed by an OSC timetag given as two integers "seconds fraction".
+ * Any other trailing arguments, as sent by buttons, are ignored.
+ *
+ * \param message : the address of the message
+ * \param value : the arguments of the message
+ * \param event : the event to be filled
+ * \return false if the message is not a valid transport command
+ */
+static bool
+parseTransportMessage(const string &message, const string &value, EngineEvent &event)
+{
+  const TransportCommandEntry *entry = std::lower_bound(TRANSPORT_COMMANDS, TRANSPORT_COMMANDS + TRANSPORT_COMMANDS_COUNT, message, transportAddressBefore);
+  if (entry == TRANSPORT_COMMANDS + TRANSPORT_COMMANDS_COUNT || *entry->address != message) {
+      return false;
+    }
+  event.command = entry->command;
+
+  const char *args = value.c_str();
+  char *argsEnd = NULL;
+  if (entry->argsCount != 0) {
+      if (entry->command == EngineEvent::SPEED) {
+          event.speed = strtod(args, &argsEnd);
+        }
+      else {
+          event.date = strtoul(args, &argsEnd, 10);
+        }
+      if (argsEnd == args) {
+          return false;
+        }
+      args = argsEnd;
+    }
+
+  // Optional timetag : exactly two integers
+  unsigned long seconds, fraction;
+  if (!parseIntegerArgument(args, seconds) || !parseIntegerArgument(args, fraction)) {
+      return true;
+    }
+  while (isspace(*args)) {
+      ++args;
     }
+  // (0, 1) means immediately
+  if (*args == '\0' && seconds != 0) {
+      event.dueTime = ((qint64)seconds - NTP_UNIX_OFFSET) * 1000000 + (qint64)(((quint64)fraction * 1000000) >> 32);
+    }
+
+  return true;
 }
 
 void
-enginesNetworkUpdateCallback(unsigned int boxID, string m1, string m2)
+Maquette::networkUpdate(const EngineEvent &event)
 {
-  Q_UNUSED(boxID);
-  MaquetteScene *scene = Maquette::getInstance()->scene();
-
-  if (scene != NULL) {
-      if (m1 == PLAY_ENGINES_MESSAGE) {
-          scene->play();
-          scene->view()->emitPlayModeChanged();
-        }
-      else if (m1 == STOP_ENGINES_MESSAGE) {
-          scene->stopWithGoto();
-          scene->view()->emitPlayModeChanged();
-        }
-      else if (m1 == STARTPOINT_ENGINES_MESSAGE) {
-          if (!m2.empty()) {
-              if(scene->playing()){
-                  scene->stopWithGoto();
-                  scene->view()->emitPlayModeChanged();
+  if (event.dueTime != 0 && event.dueTime > currentMicroseconds()) {
+      _scheduledCommands.insert(std::make_pair(event.dueTime, event));
+      scheduleNextTransportCommand();
+      return;
+    }
+  executeTransportCommand(event);
+}
+
+void
+Maquette::executeTransportCommand(const EngineEvent &event)
+{
+  if (_scene != NULL) {
+      switch (event.command) {
+          case EngineEvent::PLAY:
+            _scene->play();
+            _scene->view()->emitPlayModeChanged();
+            break;
+
+          case EngineEvent::STOP:
+            _scene->stopWithGoto();
+            _scene->view()->emitPlayModeChanged();
+            break;
+
+          case EngineEvent::START_POINT:
+            if (_scene->playing()) {
+                _scene->stopWithGoto();
+                _scene->view()->emitPlayModeChanged();
               }
-              std::istringstream iss(m2);
-              unsigned int value;
-              iss >> value;
-              scene->gotoChanged(value);
-            }
+            _scene->gotoChanged(event.date);
+            break;
+
+          case EngineEvent::REWIND:
+            _scene->stopGotoStart();
+            _scene->view()->emitPlayModeChanged();
+            break;
+
+          case EngineEvent::SPEED:
+            _scene->speedChanged(event.speed);
+            break;
+
+          case EngineEvent::NEXT_TRIGGER:
+            _scene->triggerNext();
+            break;
+
+          default:
+            break;
+        }
+    }
+#ifdef DEBUG
+  else {
+      std::cerr << "Maquette::executeTransportCommand : attribute _scene == NULL" << std::endl;
+    }
+#endif
+}
+
+void
+Maquette::scheduleNextTransportCommand()
+{
+  if (_scheduledCommands.empty()) {
+      _transportTimer.stop();
+      return;
+    }
+  // Rounded up : the timer never wakes up before the due time
+  qint64 delay = (_scheduledCommands.begin()->first - currentMicroseconds() + 999) / 1000;
+  _transportTimer.start(delay > 0 ? (int)delay : 0, this);
+}
+
+void
+Maquette::timerEvent(QTimerEvent *event)
+{
+  if (event->timerId() != _transportTimer.timerId()) {
+      QObject::timerEvent(event);
+      return;
+    }
+
+  // Commands are executed within the timer granularity
+  while (!_scheduledCommands.empty() && _scheduledCommands.begin()->first <= currentMicroseconds()) {
+      EngineEvent command = _scheduledCommands.begin()->second;
+      _scheduledCommands.erase(_scheduledCommands.begin());
+      executeTransportCommand(command);
+    }
+  scheduleNextTransportCommand();
+}
+
+void
+Maquette::postEngineEvent(const EngineEvent &event)
+{
+  if (!_engineEvents.push(event)) {
+      std::cerr << "Maquette::postEngineEvent : event queue full, event dropped" << std::endl;
+    }
+  wakeUpEngineEvents();
+}
+
+void
+Maquette::postNetworkEvent(const EngineEvent &event)
+{
+  if (!_networkEvents.push(event)) {
+      std::cerr << "Maquette::postNetworkEvent : event queue full, event dropped" << std::endl;
+    }
+  wakeUpEngineEvents();
+}
+
+void
+Maquette::wakeUpEngineEvents()
+{
+  if (_engineEventsWakeup.testAndSetOrdered(0, 1)) {
+      QMetaObject::invokeMethod(this, "processEngineEvents", Qt::QueuedConnection);
+    }
+}
+
+void
+Maquette::processEngineEvents()
+{
+  if (_processingEngineEvents) {
+      return;
+    }
+  _processingEngineEvents = true;
+
+  // Events posted from now on will request a new processing
+  _engineEventsWakeup.fetchAndStoreOrdered(0);
+
+  // Taken first : the events preceding the end of the execution are then all in the queue
+  bool finished = _engineEvents.takeExecutionFinished();
+
+  vector<EngineEvent> events;
+  EngineEvent event;
+  while (_engineEvents.pop(event)) {
+      events.push_back(event);
+    }
+
+  // Only the last transition of each control point and the last state of each trigger point matter
+  map<pair<unsigned int, unsigned int>, unsigned int> lastTransitions;
+  map<unsigned int, unsigned int> lastTriggers;
+  for (unsigned int i = 0; i < events.size(); ++i) {
+      switch (events[i].type) {
+          case EngineEvent::CROSSED_TRANSITION:
+            lastTransitions[std::make_pair(events[i].ID, events[i].CPIndex)] = i;
+            break;
+
+          case EngineEvent::CROSSED_TRIGGER_POINT:
+            lastTriggers[events[i].ID] = i;
+            break;
+
+          default:
+            break;
         }
-      else if (m1 == REWIND_ENGINES_MESSAGE) {
-          scene->stopGotoStart();
-          scene->view()->emitPlayModeChanged();
+    }
+
+  for (unsigned int i = 0; i < events.size(); ++i) {
+      if (events[i].type == EngineEvent::CROSSED_TRANSITION && lastTransitions[std::make_pair(events[i].ID, events[i].CPIndex)] == i) {
+          crossedTransition(events[i].ID, events[i].CPIndex);
         }
-      else if (m1 == SPEED_ENGINES_MESSAGE) {
-          if (!m2.empty()) {
-              std::istringstream iss(m2);
-              double value;
-              iss >> value;
-              scene->speedChanged(value);
-            }
+      else if (events[i].type == EngineEvent::CROSSED_TRIGGER_POINT && lastTriggers[events[i].ID] == i) {
+          crossedTriggerPoint(events[i].waiting, events[i].ID);
         }
-      else if (m1 == NEXT_TRIGGER_MESSAGE) {
-          scene->triggerNext();
-      }
+    }
+  if (finished) {
+      executionFinished();
+    }
 
+  while (_networkEvents.pop(event)) {
+      networkUpdate(event);
+    }
+
+  _processingEngineEvents = false;
+}
+
+void
+crossTransitionCallback(unsigned int boxID, unsigned int CPIndex, vector<unsigned int> processesToStop)
+{
+  Maquette *maquette = Maquette::getInstance();
+  maquette->postEngineEvent(EngineEvent(EngineEvent::CROSSED_TRANSITION, boxID, CPIndex));
+  for (vector<unsigned int>::iterator it = processesToStop.begin(); it != processesToStop.end(); ++it) {
+      maquette->postEngineEvent(EngineEvent(EngineEvent::CROSSED_TRANSITION, *it, END_CONTROL_POINT_INDEX));
+    }
+}
+
+void
+enginesNetworkUpdateCallback(unsigned int boxID, string m1, string m2)
+{
+  EngineEvent event(EngineEvent::NETWORK_UPDATE, boxID);
+  if (parseTransportMessage(m1, m2, event)) {
+      Maquette::getInstance()->postNetworkEvent(event);
     }
 #ifdef DEBUG
   else {
-      std::cerr << "Maquette::enginesNetworkCallback : attribute _scene == NULL" << std::endl;
+      std::cerr << "enginesNetworkUpdateCallback : unknown transport message " << m1 << " " << m2 << std::endl;
     }
 #endif
 }
@@ -2310,23 +2810,25 @@ crossTriggerPointCallback(bool waiting, unsigned int trgID, unsigned int boxID,
   Q_UNUSED(boxID);
   Q_UNUSED(CPIndex);
   Q_UNUSED(message);
-  Maquette::getInstance()->crossedTriggerPoint(waiting, trgID);
+  Maquette::getInstance()->postEngineEvent(EngineEvent(EngineEvent::CROSSED_TRIGGER_POINT, trgID, 0, waiting));
 }
 
 void
 executionFinishedCallback()
 {
-  Maquette::getInstance()->executionFinished();
+  Maquette::getInstance()->postEngineEvent(EngineEvent(EngineEvent::EXECUTION_FINISHED));
 }
 
 void
 Maquette::setStartMessageToSend(unsigned int boxID, QTreeWidgetItem *item, QString address)
 {
   _boxes[boxID]->setStartMessage(item, address);
+  invalidateBoxState(boxID);
 }
 
 void
 Maquette::setEndMessageToSend(unsigned int boxID, QTreeWidgetItem *item, QString address)
 {
   _boxes[boxID]->setEndMessage(item, address);
+  invalidateBoxState(boxID);
 }
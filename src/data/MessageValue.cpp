@@ -0,0 +1,282 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file MessageValue.cpp
+ */
+
+#include "MessageValue.hpp"
+
+#include <QByteArray>
+
+MessageValue::MessageValue()
+  : _size(0)
+{
+}
+
+MessageValue
+MessageValue::parse(const QString &value)
+{
+  MessageValue parsed;
+  QByteArray text = value.toUtf8();
+  parsed.parseAtoms(text.constData(), text.size());
+  return parsed;
+}
+
+MessageValue
+MessageValue::parse(const std::string &value)
+{
+  MessageValue parsed;
+  parsed.parseAtoms(value.data(), value.size());
+  return parsed;
+}
+
+void
+MessageValue::parseAtoms(const char *text, int length)
+{
+  int pos = 0;
+  while (pos < length) {
+      while (pos < length && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+          ++pos;
+        }
+      if (pos == length) {
+          break;
+        }
+
+      // A quoted token is one string, spaces included, its quotes being kept aside
+      if (text[pos] == '"') {
+          int begin = ++pos;
+          while (pos < length && text[pos] != '"') {
+              ++pos;
+            }
+          bool closed = pos < length;
+          append(STRING, 0, 0., QString::fromUtf8(text + begin, pos - begin), closed ? 2 : 1);
+          if (closed) {
+              ++pos;
+            }
+          continue;
+        }
+
+      int begin = pos;
+      while (pos < length && text[pos] != ' ' && text[pos] != '\t' && text[pos] != '\n' && text[pos] != '\r') {
+          ++pos;
+        }
+
+      // QByteArray conversions use the C locale, whatever the locale of the application
+      QByteArray token = QByteArray::fromRawData(text + begin, pos - begin);
+      bool ok;
+      int intValue = token.toInt(&ok);
+      if (ok) {
+          append(INT, intValue, 0., QString());
+          continue;
+        }
+      float floatValue = token.toFloat(&ok);
+      if (ok) {
+          append(FLOAT, 0, floatValue, QString());
+          continue;
+        }
+      append(STRING, 0, 0., QString::fromUtf8(text + begin, pos - begin));
+    }
+}
+
+void
+MessageValue::append(Type type, int intValue, float floatValue, const QString &stringValue, unsigned char quotes)
+{
+  Atom newAtom;
+  newAtom.type = type;
+  newAtom.quotes = quotes;
+  switch (type) {
+      case INT:
+        newAtom.i = intValue;
+        break;
+
+      case FLOAT:
+        newAtom.f = floatValue;
+        break;
+
+      default:
+        newAtom.symbol = _symbols.size();
+        _symbols << stringValue;
+        break;
+    }
+
+  if (_size < INLINE_ATOMS) {
+      _inline[_size] = newAtom;
+    }
+  else {
+      _overflow.push_back(newAtom);
+    }
+  ++_size;
+}
+
+const MessageValue::Atom &
+MessageValue::atom(unsigned int index) const
+{
+  return index < INLINE_ATOMS ? _inline[index] : _overflow[index - INLINE_ATOMS];
+}
+
+MessageValue::Type
+MessageValue::type() const
+{
+  if (_size == 0) {
+      return NONE;
+    }
+  if (_size > 1) {
+      return LIST;
+    }
+  return _inline[0].type;
+}
+
+MessageValue::Type
+MessageValue::atomType(unsigned int index) const
+{
+  if (index >= _size) {
+      return NONE;
+    }
+  return atom(index).type;
+}
+
+int
+MessageValue::toInt(unsigned int index) const
+{
+  if (index >= _size) {
+      return 0;
+    }
+  const Atom &current = atom(index);
+  switch (current.type) {
+      case INT:
+        return current.i;
+
+      case FLOAT:
+        return (int)current.f;
+
+      default:
+        return 0;
+    }
+}
+
+float
+MessageValue::toFloat(unsigned int index) const
+{
+  if (index >= _size) {
+      return 0.;
+    }
+  const Atom &current = atom(index);
+  switch (current.type) {
+      case INT:
+        return (float)current.i;
+
+      case FLOAT:
+        return current.f;
+
+      default:
+        return 0.;
+    }
+}
+
+QString
+MessageValue::toString(unsigned int index) const
+{
+  if (index >= _size) {
+      return QString();
+    }
+  const Atom &current = atom(index);
+  switch (current.type) {
+      case INT:
+        return QString::number(current.i);
+
+      case FLOAT:
+        return QString::number(current.f);
+
+      default:
+        {
+          QString quote = current.quotes > 0 ? QString("\"") : QString();
+          return quote + _symbols.at(current.symbol) + (current.quotes > 1 ? quote : QString());
+        }
+    }
+}
+
+QString
+MessageValue::toSymbol(unsigned int index) const
+{
+  if (index >= _size || atom(index).type != STRING) {
+      return toString(index);
+    }
+  return _symbols.at(atom(index).symbol);
+}
+
+QString
+MessageValue::toString() const
+{
+  QString text;
+  for (unsigned int i = 0; i < _size; ++i) {
+      if (i > 0) {
+          text += " ";
+        }
+      text += toString(i);
+    }
+  return text;
+}
+
+bool
+MessageValue::operator==(const MessageValue &other) const
+{
+  if (_size != other._size) {
+      return false;
+    }
+  for (unsigned int i = 0; i < _size; ++i) {
+      const Atom &mine = atom(i);
+      const Atom &theirs = other.atom(i);
+      bool myString = mine.type == STRING, theirString = theirs.type == STRING;
+      if (myString != theirString) {
+          return false;
+        }
+      if (myString) {
+          if (mine.quotes != theirs.quotes || _symbols.at(mine.symbol) != other._symbols.at(theirs.symbol)) {
+              return false;
+            }
+        }
+      else if (mine.type == INT && theirs.type == INT) {
+          if (mine.i != theirs.i) {
+              return false;
+            }
+        }
+      else if (toFloat(i) != other.toFloat(i)) {
+          return false;
+        }
+    }
+  return true;
+}
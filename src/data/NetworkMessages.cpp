@@ -57,51 +57,96 @@ NetworkMessages::NetworkMessages()
   init();
 }
 
-NetworkMessages::NetworkMessages(QMap<QTreeWidgetItem *, Message> *msgs)
+NetworkMessages::NetworkMessages(const NetworkMessages *messages)
+  : QObject(), _messages(messages->_messages), _itemAddresses(messages->_itemAddresses), _addressItems(messages->_addressItems),
+  _compiled(messages->_compiled), _compiledValid(messages->_compiledValid)
 {
-  _messages = new QMap<QTreeWidgetItem *, Message>(*msgs);
 }
 
 void
 NetworkMessages::init()
 {
-  _messages = new QMap<QTreeWidgetItem *, Message>();
+  _messages.clear();
+  _itemAddresses.clear();
+  _addressItems.clear();
+  _compiled.clear();
+  _compiledValid = true;
 }
 
 NetworkMessages::~NetworkMessages()
 {
-  _messages->clear();
 }
 
 
 void
 NetworkMessages::clear()
 {
-  _messages->clear();
+  init();
   emit(messagesChanged());
 }
 
 void
 NetworkMessages::clearDevicesMsgs(QList<QString> devices)
 {
-  QList<QTreeWidgetItem *> messagesList = _messages->keys();
-  QList<QTreeWidgetItem *>::iterator it;
-  QTreeWidgetItem *curItem;
-  Message curMsg;
+  QList<AddressID> addresses = _messages.keys();
+  QList<AddressID>::iterator it;
 
-  for (it = messagesList.begin(); it != messagesList.end(); it++) {
-      curItem = *it;
-      curMsg = _messages->value(curItem);
-      if (devices.contains(curMsg.device)) {
-          _messages->remove(curItem);
+  for (it = addresses.begin(); it != addresses.end(); it++) {
+      if (devices.contains(_messages.value(*it).device)) {
+          removeAddress(*it);
         }
     }
 }
 
-QMap<QTreeWidgetItem *, Message> *
-NetworkMessages::getMessages()
+Message
+NetworkMessages::message(QTreeWidgetItem *item) const
 {
-  return _messages;
+  QHash<QTreeWidgetItem *, AddressID>::const_iterator it = _itemAddresses.find(item);
+  if (it != _itemAddresses.end()) {
+      return _messages.value(it.value());
+    }
+  return Message();
+}
+
+void
+NetworkMessages::removeAddress(AddressID address)
+{
+  QTreeWidgetItem *item = _addressItems.take(address);
+  if (item != NULL) {
+      _itemAddresses.remove(item);
+    }
+  if (_messages.remove(address) != 0) {
+      _compiledValid = false;
+      emit(messageRemoved(address));
+    }
+}
+
+void
+NetworkMessages::link(QTreeWidgetItem *item, AddressID address)
+{
+  if (item == NULL) {
+      return;
+    }
+  QHash<QTreeWidgetItem *, AddressID>::iterator it = _itemAddresses.find(item);
+  if (it != _itemAddresses.end()) {
+      if (it.value() == address) {
+          return;
+        }
+      // The item now shows another address : the message of its previous address is dropped
+      AddressID previous = it.value();
+      _itemAddresses.erase(it);
+      _addressItems.remove(previous);
+      if (_messages.remove(previous) != 0) {
+          _compiledValid = false;
+          emit(messageRemoved(previous));
+        }
+    }
+  QTreeWidgetItem *previousItem = _addressItems.value(address, NULL);
+  if (previousItem != NULL) {
+      _itemAddresses.remove(previousItem);
+    }
+  _itemAddresses.insert(item, address);
+  _addressItems.insert(address, item);
 }
 
 bool
@@ -164,17 +209,27 @@ NetworkMessages::computeMessage(const Message &msg)
 QMap<QString, QString>
 NetworkMessages::toMapAddressValue()
 {
-  QString address;
   QMap<QString, QString> messages;
-  QMap<QTreeWidgetItem *, Message>::iterator it;
+  QMap<AddressID, Message>::iterator it;
 
-  for (it = _messages->begin(); it != _messages->end(); it++) {
-      address = QString::fromStdString(computeMessageWithoutValue(*it));
-      messages.insert(address, (*it).value);
+  for (it = _messages.begin(); it != _messages.end(); it++) {
+      messages.insert(AddressTable::address(it.key()), (*it).value);
     }
   return messages;
 }
 
+QMap<AddressID, QString>
+NetworkMessages::values() const
+{
+  QMap<AddressID, QString> values;
+  QMap<AddressID, Message>::const_iterator it;
+
+  for (it = _messages.begin(); it != _messages.end(); it++) {
+      values.insert(it.key(), (*it).value);
+    }
+  return values;
+}
+
 std::string
 NetworkMessages::computeMessageWithoutValue(const Message &msg)
 {
@@ -198,42 +253,45 @@ NetworkMessages::computeMessageWithoutValue(const Message &msg)
 }
 
 
-vector<string>
-NetworkMessages::computeMessages()
+const vector<string> &
+NetworkMessages::computeMessages() const
 {
-  vector<string> msgs;
-  QMap<QTreeWidgetItem *, Message>::iterator it;
-  for (it = _messages->begin(); it != _messages->end(); it++) {
-      string lineMsg = computeMessage(*it);
-      if (lineMsg != "") {
-          msgs.push_back(lineMsg);
-        }
-      else {
-          std::cerr << "NetworkMessages::computeMessages : bad message ignored" << std::endl;
+  if (!_compiledValid) {
+      _compiled.clear();
+      _compiled.reserve(_messages.size());
+      QMap<AddressID, Message>::const_iterator it;
+      for (it = _messages.begin(); it != _messages.end(); it++) {
+          if (!it->compiled.empty()) {
+              _compiled.push_back(it->compiled);
+            }
+          else {
+              std::cerr << "NetworkMessages::computeMessages : bad message ignored" << std::endl;
+            }
         }
+      _compiledValid = true;
     }
-  return msgs;
+  return _compiled;
+}
+
+void
+NetworkMessages::compile(Message &msg)
+{
+  msg.parsedValue = MessageValue::parse(msg.value);
+  msg.compiled = computeMessage(msg);
+  _compiledValid = false;
 }
 
 void
 NetworkMessages::changeMessage(QTreeWidgetItem *item, QString newName)
 {
-  QMap<QTreeWidgetItem *, Message>::iterator it = _messages->find(item);
-  Message msg;
+  QHash<QTreeWidgetItem *, AddressID>::iterator it = _itemAddresses.find(item);
 
-  if (it != _messages->end()) {
-      msg = it.value();
+  if (it != _itemAddresses.end()) {
+      Message msg = _messages.value(it.value());
       newName.push_front("/");
       msg.message = newName;
-      _messages->remove(item);
-      _messages->insert(item, msg);
-
-      //print
-//        std::vector<std::string> list = computeMessages();
-//        std::cout<<"change name in : "<<std::endl;
-//        for(int i = 0 ; i<list.size() ; i++)
-//            std::cout<<list[i]<<std::endl;
-      //endPrint
+      removeAddress(it.value());
+      addMessage(item, msg.device, msg.message, msg.value);
     }
   else {
       std::cerr << "NetworkMessages::changeMessage : item not found" << std::endl;
@@ -243,17 +301,16 @@ NetworkMessages::changeMessage(QTreeWidgetItem *item, QString newName)
 void
 NetworkMessages::changeDevice(QString oldName, QString newName)
 {
-  QMap<QTreeWidgetItem *, Message>::iterator it;
-  QTreeWidgetItem *curItem;
+  QList<AddressID> addresses = _messages.keys();
+  QList<AddressID>::iterator it;
   Message msg;
 
-  for (it = _messages->begin(); it != _messages->end(); it++) {
-      curItem = it.key();
-      msg = it.value();
+  for (it = addresses.begin(); it != addresses.end(); it++) {
+      msg = _messages.value(*it);
       if (msg.device == oldName) {
-          msg.device = newName;
-          _messages->remove(curItem);
-          _messages->insert(curItem, msg);
+          QTreeWidgetItem *item = _addressItems.value(*it, NULL);
+          removeAddress(*it);
+          addMessage(item, newName, msg.message, msg.value);
         }
     }
 }
@@ -261,14 +318,24 @@ NetworkMessages::changeDevice(QString oldName, QString newName)
 void
 NetworkMessages::addMessage(QTreeWidgetItem *treeItem, const QString &device, const QString &message, const QString &value)
 {
-  Message msg = { device, message, value };
-  _messages->insert(treeItem, msg);
+  Message msg;
+  msg.device = device;
+  msg.message = message;
+  msg.value = value;
+  compile(msg);
+  AddressID address = AddressTable::intern(device + message);
+  link(treeItem, address);
+  _messages.insert(address, msg);
+  emit(messageChanged(address));
 }
 
 void
 NetworkMessages::removeMessage(QTreeWidgetItem *item)
 {
-  _messages->remove(item);
+  QHash<QTreeWidgetItem *, AddressID>::iterator it = _itemAddresses.find(item);
+  if (it != _itemAddresses.end()) {
+      removeAddress(it.value());
+    }
 }
 
 void
@@ -484,10 +551,12 @@ NetworkMessages::addMessages(const QList < QPair<QTreeWidgetItem *, QString> > m
 bool
 NetworkMessages::setValue(QTreeWidgetItem *item, QString newValue)
 {
-  if (_messages->contains(item)) {
-      Message newMsg = _messages->value(item);
-      newMsg.value = newValue;
-      _messages->insert(item, newMsg);
+  QHash<QTreeWidgetItem *, AddressID>::iterator it = _itemAddresses.find(item);
+  if (it != _itemAddresses.end()) {
+      Message &msg = _messages[it.value()];
+      msg.value = newValue;
+      compile(msg);
+      emit(messageChanged(it.value()));
       return true;
     }
   else {
@@ -498,19 +567,4 @@ NetworkMessages::setValue(QTreeWidgetItem *item, QString newValue)
     }
 }
 
-void
-NetworkMessages::setDeviceMessages(QString deviceName, QMap<QTreeWidgetItem *, Message> *messages)
-{
-  Q_UNUSED(messages);
-  QMap<QTreeWidgetItem *, Message>::iterator it;
-  Message curMsg;
-
-  for (it = _messages->begin(); it != _messages->end(); it++) {
-      curMsg = *it;
-      if (curMsg.device == deviceName) {
-          _messages->erase(it);
-        }
-    }
-}
-
 
@@ -0,0 +1,143 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file OSCBundle.cpp
+ */
+
+#include "OSCBundle.hpp"
+#include "MessageValue.hpp"
+
+#include <vector>
+#include <string.h>
+
+using std::string;
+using std::vector;
+
+/*!
+ * \brief Appends a big endian 32 bits word.
+ */
+static void
+appendInt32(QByteArray &data, quint32 value)
+{
+  data.append((char)((value >> 24) & 0xFF));
+  data.append((char)((value >> 16) & 0xFF));
+  data.append((char)((value >> 8) & 0xFF));
+  data.append((char)(value & 0xFF));
+}
+
+/*!
+ * \brief Appends an OSC string : null terminated and padded to 4 bytes.
+ */
+static void
+appendString(QByteArray &data, const string &value)
+{
+  data.append(value.c_str(), value.size());
+  int padding = 4 - (value.size() % 4);
+  data.append(QByteArray(padding, '\0'));
+}
+
+OSCBundle::OSCBundle(quint32 seconds, quint32 fraction)
+{
+  _seconds = seconds;
+  _fraction = fraction;
+  clear();
+}
+
+void
+OSCBundle::clear()
+{
+  _data.clear();
+  appendString(_data, "#bundle");
+  appendInt32(_data, _seconds);
+  appendInt32(_data, _fraction);
+  _size = 0;
+}
+
+QByteArray
+OSCBundle::encodeMessage(const string &address, const string &arguments)
+{
+  string typeTags = ",";
+  QByteArray argumentsData;
+
+  // Quoted strings are kept as one argument
+  MessageValue value = MessageValue::parse(arguments);
+  for (unsigned int i = 0; i < value.size(); ++i) {
+      switch (value.atomType(i)) {
+          case MessageValue::INT:
+            typeTags += 'i';
+            appendInt32(argumentsData, (quint32)(qint32)value.toInt(i));
+            break;
+
+          case MessageValue::FLOAT:
+          {
+            float floatValue = value.toFloat(i);
+            quint32 bits;
+            memcpy(&bits, &floatValue, sizeof(bits));
+            typeTags += 'f';
+            appendInt32(argumentsData, bits);
+            break;
+          }
+
+          default:
+            typeTags += 's';
+            appendString(argumentsData, string(value.toSymbol(i).toUtf8().constData()));
+            break;
+        }
+    }
+
+  QByteArray message;
+  appendString(message, address);
+  appendString(message, typeTags);
+  message.append(argumentsData);
+
+  return message;
+}
+
+bool
+OSCBundle::addMessage(const string &address, const string &arguments)
+{
+  QByteArray message = encodeMessage(address, arguments);
+  if (_size > 0 && _data.size() + 4 + message.size() > MAX_SIZE) {
+      return false;
+    }
+
+  appendInt32(_data, message.size());
+  _data.append(message);
+  _size++;
+
+  return true;
+}
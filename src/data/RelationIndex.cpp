@@ -0,0 +1,153 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file RelationIndex.cpp
+ */
+
+#include "RelationIndex.hpp"
+
+using std::vector;
+
+void
+RelationIndex::clear()
+{
+  _relations.clear();
+  _attachments.clear();
+}
+
+void
+RelationIndex::addRelation(unsigned int relID, const RelationEnds &ends)
+{
+  removeRelation(relID);
+  _relations[relID] = ends;
+  attach(ends.firstBox, relID, ends.firstExtremity);
+  attach(ends.secondBox, relID, ends.secondExtremity);
+}
+
+void
+RelationIndex::removeRelation(unsigned int relID)
+{
+  EntityStore<RelationEnds>::iterator it = _relations.find(relID);
+  if (it != _relations.end()) {
+      detach(it->second.firstBox, relID);
+      detach(it->second.secondBox, relID);
+      _relations.erase(it);
+    }
+}
+
+bool
+RelationIndex::contains(unsigned int relID) const
+{
+  return _relations.contains(relID);
+}
+
+void
+RelationIndex::boxRelations(unsigned int boxID, vector<unsigned int> &relations) const
+{
+  relations.clear();
+  EntityStore<vector<Attachment> >::const_iterator it = _attachments.find(boxID);
+  if (it != _attachments.end()) {
+      for (vector<Attachment>::const_iterator att = it->second.begin(); att != it->second.end(); ++att) {
+          // A relation between both extremities of a box is attached twice
+          if (att == it->second.begin() || (att - 1)->relID != att->relID) {
+              relations.push_back(att->relID);
+            }
+        }
+    }
+}
+
+void
+RelationIndex::boxRelations(unsigned int boxID, BoxExtremity extremity, vector<unsigned int> &relations) const
+{
+  relations.clear();
+  EntityStore<vector<Attachment> >::const_iterator it = _attachments.find(boxID);
+  if (it != _attachments.end()) {
+      for (vector<Attachment>::const_iterator att = it->second.begin(); att != it->second.end(); ++att) {
+          if (att->extremity == extremity) {
+              relations.push_back(att->relID);
+            }
+        }
+    }
+}
+
+bool
+RelationIndex::areRelated(unsigned int ID1, unsigned int ID2) const
+{
+  EntityStore<vector<Attachment> >::const_iterator it = _attachments.find(ID1);
+  if (it != _attachments.end()) {
+      for (vector<Attachment>::const_iterator att = it->second.begin(); att != it->second.end(); ++att) {
+          EntityStore<RelationEnds>::const_iterator rel = _relations.find(att->relID);
+          if (rel == _relations.end()) {
+              continue;
+            }
+          const RelationEnds &ends = rel->second;
+          if ((ends.firstBox == ID1 && ends.secondBox == ID2) || (ends.firstBox == ID2 && ends.secondBox == ID1)) {
+              return true;
+            }
+        }
+    }
+  return false;
+}
+
+void
+RelationIndex::attach(unsigned int boxID, unsigned int relID, BoxExtremity extremity)
+{
+  Attachment attachment;
+  attachment.relID = relID;
+  attachment.extremity = extremity;
+  _attachments[boxID].push_back(attachment);
+}
+
+void
+RelationIndex::detach(unsigned int boxID, unsigned int relID)
+{
+  EntityStore<vector<Attachment> >::iterator it = _attachments.find(boxID);
+  if (it != _attachments.end()) {
+      vector<Attachment> &attachments = it->second;
+      for (unsigned int i = 0; i < attachments.size(); ) {
+          if (attachments[i].relID == relID) {
+              attachments.erase(attachments.begin() + i);
+            }
+          else {
+              ++i;
+            }
+        }
+      if (attachments.empty()) {
+          _attachments.erase(it);
+        }
+    }
+}
@@ -0,0 +1,425 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file ScoreFile.cpp
+ */
+
+#include "ScoreFile.hpp"
+#include "CSPTypes.hpp"
+
+#include <QFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+/*!
+ * \brief Elements of an XML score.
+ */
+enum XmlTag {
+  UNKNOWN_TAG,
+  GRAPHICS_TAG,
+  BOX_TAG,
+  POSITION_TAG,
+  DATE_TAG,
+  TOP_LEFT_TAG,
+  SIZE_TAG,
+  COLOR_TAG,
+  DEVICES_TAG,
+  DEVICE_TAG,
+  OSC_MESSAGES_TAG,
+  OSC_TAG
+};
+
+/*!
+ * \brief Gets the element of an XML score from its tag name, switching on its length.
+ */
+static XmlTag
+xmlTag(const QStringRef &name)
+{
+  switch (name.size()) {
+      case 3:
+        if (name == QLatin1String("box")) {
+            return BOX_TAG;
+          }
+        if (name == QLatin1String("OSC")) {
+            return OSC_TAG;
+          }
+        break;
+
+      case 4:
+        if (name == QLatin1String("date")) {
+            return DATE_TAG;
+          }
+        if (name == QLatin1String("size")) {
+            return SIZE_TAG;
+          }
+        break;
+
+      case 5:
+        if (name == QLatin1String("color")) {
+            return COLOR_TAG;
+          }
+        break;
+
+      case 6:
+        if (name == QLatin1String("Device")) {
+            return DEVICE_TAG;
+          }
+        break;
+
+      case 7:
+        if (name == QLatin1String("Devices")) {
+            return DEVICES_TAG;
+          }
+        break;
+
+      case 8:
+        if (name == QLatin1String("GRAPHICS")) {
+            return GRAPHICS_TAG;
+          }
+        if (name == QLatin1String("position")) {
+            return POSITION_TAG;
+          }
+        if (name == QLatin1String("top-left")) {
+            return TOP_LEFT_TAG;
+          }
+        break;
+
+      case 11:
+        if (name == QLatin1String("OSCMessages")) {
+            return OSC_MESSAGES_TAG;
+          }
+        break;
+    }
+  return UNKNOWN_TAG;
+}
+
+/*!
+ * \brief Gets an attribute of an element of an XML score.
+ */
+static inline QString
+xmlAttribute(const QXmlStreamAttributes &attributes, const char *name, const QString &defaultValue = QString())
+{
+  QStringRef value = attributes.value(QLatin1String(name));
+  return value.isNull() ? defaultValue : value.toString();
+}
+
+ScoreFile::ScoreFile()
+  : zoom(1.), devicesState(PART_ABSENT), OSCMessagesState(PART_ABSENT)
+{
+}
+
+ScoreFile::Status
+ScoreFile::read(const QString &fileName, unsigned int expectedBoxes)
+{
+  _error.clear();
+  QFile file(fileName);
+  if (!file.open(QFile::ReadOnly | QFile::Text)) {
+      _error = file.errorString();
+      return OPEN_ERROR;
+    }
+  return readXml(file, expectedBoxes);
+}
+
+ScoreFile::Status
+ScoreFile::readXml(QIODevice &device, unsigned int expectedBoxes)
+{
+  QXmlStreamReader reader(&device);
+  bool iscoreDocument = false;
+  boxes.clear();
+  boxes.reserve(expectedBoxes);
+  std::vector<XmlTag> rootChildren;   // elements under the root, in the document order
+
+  static const int MAX_DEPTH = 8;
+  XmlTag path[MAX_DEPTH];             // elements from the root to the current one
+  int depth = 0;
+
+  while (!reader.atEnd()) {
+      switch (reader.readNext()) {
+          case QXmlStreamReader::DTD:
+            iscoreDocument = reader.dtdName() == QLatin1String("i-scoreSave");
+            break;
+
+          case QXmlStreamReader::StartElement:
+            {
+              if (depth == 0 && !iscoreDocument) {
+                  return NOT_A_SCORE;
+                }
+
+              XmlTag tag = xmlTag(reader.name());
+              XmlTag parent = depth > 0 ? path[std::min(depth, MAX_DEPTH) - 1] : UNKNOWN_TAG;
+              QXmlStreamAttributes attributes = reader.attributes();
+
+              if (depth == 0) {
+                  if (tag != GRAPHICS_TAG) {
+                      _error = reader.name().toString();
+                      return INVALID_ROOT;
+                    }
+                  zoom = xmlAttribute(attributes, "zoom", "1").toFloat();
+                  center = QPointF(xmlAttribute(attributes, "centerX", "0.").toFloat(),
+                                   xmlAttribute(attributes, "centerY", "0.").toFloat());
+                }
+              else if (depth == 1) {
+                  rootChildren.push_back(tag);
+                }
+              else if (depth == 2 && tag == BOX_TAG) {
+                  Box box;
+                  box.ID = xmlAttribute(attributes, "ID", QString("%1").arg(NO_ID)).toInt();
+                  box.type = xmlAttribute(attributes, "type", "unknown");
+                  box.name = xmlAttribute(attributes, "name", "unknown");
+                  box.mother = xmlAttribute(attributes, "mother", QString("%1").arg(ROOT_BOX_ID)).toInt();
+                  box.begin = box.duration = box.topLeftY = box.sizeY = 0;
+                  box.color = QColor(1, 1, 1);
+                  boxes.push_back(box);
+                }
+              else if (depth == 2 && tag == DEVICE_TAG && parent == DEVICES_TAG) {
+                  Device device;
+                  device.name = xmlAttribute(attributes, "name");
+                  device.ip = xmlAttribute(attributes, "IP");
+                  device.port = xmlAttribute(attributes, "port");
+                  device.plugin = xmlAttribute(attributes, "plugin");
+                  devices.push_back(device);
+                }
+              else if (depth == 2 && tag == OSC_TAG && parent == OSC_MESSAGES_TAG) {
+                  OSCMessages << xmlAttribute(attributes, "message");
+                }
+              else if (depth == 3 && tag == COLOR_TAG && parent == BOX_TAG) {
+                  boxes.back().color = QColor(xmlAttribute(attributes, "red", "1").toInt(), xmlAttribute(attributes, "green", "1").toInt(),
+                                              xmlAttribute(attributes, "blue", "1").toInt());
+                }
+              else if (depth == 4 && parent == POSITION_TAG && path[2] == BOX_TAG) {
+                  Box &box = boxes.back();
+                  switch (tag) {
+                      case DATE_TAG:
+                        box.begin = xmlAttribute(attributes, "begin", "0").toInt();
+                        box.duration = xmlAttribute(attributes, "duration", "0").toInt();
+                        break;
+
+                      case TOP_LEFT_TAG:
+                        box.topLeftY = box.sizeY = xmlAttribute(attributes, "y", "0").toInt();
+                        break;
+
+                      case SIZE_TAG:
+                        box.sizeY = xmlAttribute(attributes, "y", "0").toInt();
+                        break;
+
+                      default:
+                        break;
+                    }
+                }
+
+              if (depth < MAX_DEPTH) {
+                  path[depth] = tag;
+                }
+              ++depth;
+              break;
+            }
+
+          case QXmlStreamReader::EndElement:
+            --depth;
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  if (reader.hasError()) {
+      _error = reader.errorString();
+      return FORMAT_ERROR;
+    }
+  if (!iscoreDocument) {
+      return NOT_A_SCORE;
+    }
+
+  // Devices and OSC messages are expected as the second and third elements under the root
+  if (rootChildren.size() >= 2) {
+      devicesState = rootChildren[1] == DEVICES_TAG ? PART_PRESENT : PART_MISPLACED;
+      OSCMessagesState = rootChildren.size() >= 3 && rootChildren[2] == OSC_MESSAGES_TAG ? PART_PRESENT : PART_MISPLACED;
+    }
+
+  return READ_OK;
+}
+
+/*!
+ * \brief Flushes a file being written and syncs it to the disk.
+ */
+static bool
+syncFile(QFile &file, QString &error)
+{
+  if (!file.flush()) {
+      error = file.errorString();
+      return false;
+    }
+  if (fsync(file.handle()) != 0) {
+      error = QString::fromLocal8Bit(strerror(errno));
+      return false;
+    }
+  return true;
+}
+
+/*!
+ * \brief Renames a file over another one.
+ */
+static bool
+renameFile(const QString &from, const QString &to, QString &error)
+{
+  if (::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) != 0) {
+      error = QString::fromLocal8Bit(strerror(errno));
+      return false;
+    }
+  return true;
+}
+
+bool
+ScoreFile::write(const QString &fileName, const QString &enginesTempName)
+{
+  _error.clear();
+
+  // Written beside the file, then renamed over it : a failed save leaves the previous file intact
+  QString tempName = fileName + ".tmp";
+  QFile file(tempName);
+  bool written = file.open(QFile::WriteOnly | QFile::Truncate);
+  if (written) {
+      written = writeXml(file);
+      if (!written && _error.isEmpty()) {
+          _error = file.errorString();
+        }
+      written = written && syncFile(file, _error);
+      file.close();
+    }
+  else {
+      _error = file.errorString();
+    }
+
+  // The Engines part, already written, is only renamed with a complete score
+  if (written && !enginesTempName.isEmpty()) {
+      QFile enginesFile(enginesTempName);
+      if (!enginesFile.open(QFile::ReadOnly)) {
+          _error = QString("%1 : %2").arg(enginesTempName).arg(enginesFile.errorString());
+          written = false;
+        }
+      else {
+          written = syncFile(enginesFile, _error);
+          enginesFile.close();
+        }
+      written = written && renameFile(enginesTempName, fileName + ".simone", _error);
+    }
+  written = written && renameFile(tempName, fileName, _error);
+
+  if (!written) {
+      QFile::remove(tempName);
+      if (!enginesTempName.isEmpty()) {
+          QFile::remove(enginesTempName);
+        }
+    }
+  return written;
+}
+
+bool
+ScoreFile::writeXml(QIODevice &device)
+{
+  QXmlStreamWriter writer(&device);
+  writer.setAutoFormatting(true);
+  writer.setAutoFormattingIndent(1);
+  writer.writeStartDocument();
+  writer.writeDTD("<!DOCTYPE i-scoreSave PUBLIC \"i-score 2012\" \"http://scrime.labri.fr\">");
+
+  writer.writeStartElement("GRAPHICS");
+  writer.writeAttribute("zoom", QString::number(zoom));
+  writer.writeAttribute("centerX", QString::number(center.x()));
+  writer.writeAttribute("centerY", QString::number(center.y()));
+
+  writer.writeStartElement("boxes");
+  std::vector<Box>::const_iterator boxIt;
+  for (boxIt = boxes.begin(); boxIt != boxes.end(); ++boxIt) {
+      writer.writeStartElement("box");
+      writer.writeAttribute("type", boxIt->type);
+      writer.writeAttribute("ID", QString::number(boxIt->ID));
+      writer.writeAttribute("name", boxIt->name);
+      writer.writeAttribute("mother", QString::number(boxIt->mother));
+
+      writer.writeStartElement("position");
+
+      writer.writeEmptyElement("date");
+      writer.writeAttribute("begin", QString::number(boxIt->begin));
+      writer.writeAttribute("duration", QString::number(boxIt->duration));
+
+      writer.writeEmptyElement("top-left");
+      writer.writeAttribute("y", QString::number(boxIt->topLeftY));
+
+      writer.writeEmptyElement("size");
+      writer.writeAttribute("y", QString::number(boxIt->sizeY));
+
+      writer.writeEndElement(); // position
+
+      writer.writeEmptyElement("color");
+      writer.writeAttribute("red", QString::number(boxIt->color.red()));
+      writer.writeAttribute("green", QString::number(boxIt->color.green()));
+      writer.writeAttribute("blue", QString::number(boxIt->color.blue()));
+
+      writer.writeEndElement(); // box
+    }
+  writer.writeEndElement(); // boxes
+
+  writer.writeStartElement("Devices");
+  std::vector<Device>::const_iterator deviceIt;
+  for (deviceIt = devices.begin(); deviceIt != devices.end(); ++deviceIt) {
+      writer.writeEmptyElement("Device");
+      writer.writeAttribute("IP", deviceIt->ip);
+      writer.writeAttribute("port", deviceIt->port);
+      writer.writeAttribute("plugin", deviceIt->plugin);
+      writer.writeAttribute("name", deviceIt->name);
+    }
+  writer.writeEndElement(); // Devices
+
+  writer.writeStartElement("OSCMessages");
+  QStringList::const_iterator messageIt;
+  for (messageIt = OSCMessages.begin(); messageIt != OSCMessages.end(); ++messageIt) {
+      writer.writeEmptyElement("OSC");
+      writer.writeAttribute("message", *messageIt);
+    }
+  writer.writeEndElement(); // OSCMessages
+
+  writer.writeEndElement(); // GRAPHICS
+  writer.writeEndDocument();
+
+  return !writer.hasError();
+}
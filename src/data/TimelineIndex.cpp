@@ -0,0 +1,416 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file TimelineIndex.cpp
+ */
+
+#include "TimelineIndex.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using std::vector;
+using std::map;
+using std::pair;
+
+bool
+TimelineIndex::writeBefore(const TimelineWrite &write1, const TimelineWrite &write2)
+{
+  if (write1.date != write2.date) {
+      return write1.date < write2.date;
+    }
+  if (write1.boxID != write2.boxID) {
+      return write1.boxID > write2.boxID;
+    }
+  return !write1.end && write2.end;
+}
+
+static bool
+writeDateAfter(unsigned int date, const TimelineWrite &write)
+{
+  return date < write.date;
+}
+
+static bool
+endDateBefore(const pair<unsigned int, unsigned int> &interval, unsigned int date)
+{
+  return interval.first < date;
+}
+
+bool
+TimelineIndex::ChronologyKey::operator<(const ChronologyKey &other) const
+{
+  if (date != other.date) {
+      return date < other.date;
+    }
+  if (boxID != other.boxID) {
+      return boxID > other.boxID;
+    }
+  if (end != other.end) {
+      return !end;
+    }
+  return address < other.address;
+}
+
+TimelineIndex::TimelineIndex(unsigned int checkpointInterval)
+{
+  _intervalsDirty = false;
+  _checkpointInterval = checkpointInterval;
+}
+
+void
+TimelineIndex::clear()
+{
+  _boxes.clear();
+  _writes.clear();
+  _intervals.clear();
+  _maxEnds.clear();
+  _ends.clear();
+  _intervalsDirty = false;
+  _chronology.clear();
+  _checkpoints.clear();
+  _checkpointsMemory.clear();
+}
+
+void
+TimelineIndex::insertWrite(AddressID address, const TimelineWrite &write)
+{
+  vector<TimelineWrite> &writes = _writes[address];
+  writes.insert(std::upper_bound(writes.begin(), writes.end(), write, writeBefore), write);
+
+  ChronologyKey key;
+  key.date = write.date;
+  key.boxID = write.boxID;
+  key.end = write.end;
+  key.address = address;
+  _chronology[key] = write.value;
+}
+
+void
+TimelineIndex::setBox(unsigned int boxID, unsigned int begin, unsigned int end,
+                      const QMap<AddressID, QString> &startMessages, const QMap<AddressID, QString> &endMessages)
+{
+  removeBox(boxID);
+
+  BoxRecord &record = _boxes[boxID];
+  record.begin = begin;
+  record.end = end;
+  invalidateCheckpoints(begin);
+
+  TimelineWrite write;
+  write.boxID = boxID;
+
+  write.date = begin;
+  write.end = false;
+  for (QMap<AddressID, QString>::const_iterator it = startMessages.begin(); it != startMessages.end(); ++it) {
+      write.value = it.value();
+      insertWrite(it.key(), write);
+      record.addresses.push_back(it.key());
+    }
+
+  write.date = end;
+  write.end = true;
+  for (QMap<AddressID, QString>::const_iterator it = endMessages.begin(); it != endMessages.end(); ++it) {
+      write.value = it.value();
+      insertWrite(it.key(), write);
+      if (!startMessages.contains(it.key())) {
+          record.addresses.push_back(it.key());
+        }
+    }
+
+  _intervalsDirty = true;
+}
+
+void
+TimelineIndex::removeBox(unsigned int boxID)
+{
+  map<unsigned int, BoxRecord>::iterator boxIt = _boxes.find(boxID);
+  if (boxIt == _boxes.end()) {
+      return;
+    }
+
+  invalidateCheckpoints(boxIt->second.begin);
+
+  ChronologyKey key;
+  key.boxID = boxID;
+  for (vector<AddressID>::iterator it = boxIt->second.addresses.begin(); it != boxIt->second.addresses.end(); ++it) {
+      key.address = *it;
+      key.date = boxIt->second.begin;
+      key.end = false;
+      _chronology.erase(key);
+      key.date = boxIt->second.end;
+      key.end = true;
+      _chronology.erase(key);
+
+      QHash<AddressID, vector<TimelineWrite> >::iterator writesIt = _writes.find(*it);
+      if (writesIt != _writes.end()) {
+          vector<TimelineWrite> &writes = writesIt.value();
+          for (unsigned int i = 0; i < writes.size(); ) {
+              if (writes[i].boxID == boxID) {
+                  writes.erase(writes.begin() + i);
+                }
+              else {
+                  ++i;
+                }
+            }
+          if (writes.empty()) {
+              _writes.erase(writesIt);
+            }
+        }
+    }
+
+  _boxes.erase(boxIt);
+  _intervalsDirty = true;
+}
+
+void
+TimelineIndex::rebuildIntervals()
+{
+  if (!_intervalsDirty) {
+      return;
+    }
+
+  // Boxes are sorted by ID, so intervals sharing a begin date stay sorted by ID
+  vector<pair<unsigned int, unsigned int> > begins;
+  begins.reserve(_boxes.size());
+  _ends.clear();
+  _ends.reserve(_boxes.size());
+  for (map<unsigned int, BoxRecord>::iterator it = _boxes.begin(); it != _boxes.end(); ++it) {
+      begins.push_back(pair<unsigned int, unsigned int>(it->second.begin, it->first));
+      _ends.push_back(pair<unsigned int, unsigned int>(it->second.end, it->first));
+    }
+  std::stable_sort(begins.begin(), begins.end());
+  std::stable_sort(_ends.begin(), _ends.end());
+
+  _intervals.resize(begins.size());
+  for (unsigned int i = 0; i < begins.size(); ++i) {
+      _intervals[i].begin = begins[i].first;
+      _intervals[i].boxID = begins[i].second;
+      _intervals[i].end = _boxes[begins[i].second].end;
+    }
+
+  _maxEnds.resize(_intervals.size());
+  buildMaxEnds(0, _intervals.size());
+
+  _intervalsDirty = false;
+}
+
+unsigned int
+TimelineIndex::buildMaxEnds(unsigned int first, unsigned int last)
+{
+  if (first >= last) {
+      return 0;
+    }
+
+  // The interval tree is implicit : each subtree is rooted at the middle of its range
+  unsigned int middle = first + (last - first) / 2;
+  unsigned int maxEnd = _intervals[middle].end;
+  maxEnd = std::max(maxEnd, buildMaxEnds(first, middle));
+  maxEnd = std::max(maxEnd, buildMaxEnds(middle + 1, last));
+  _maxEnds[middle] = maxEnd;
+
+  return maxEnd;
+}
+
+void
+TimelineIndex::stab(unsigned int first, unsigned int last, unsigned int date, vector<unsigned int> &boxes) const
+{
+  if (first >= last) {
+      return;
+    }
+
+  unsigned int middle = first + (last - first) / 2;
+  if (_maxEnds[middle] <= date) {
+      return;
+    }
+
+  stab(first, middle, date, boxes);
+  if (_intervals[middle].begin < date) {
+      if (_intervals[middle].end > date) {
+          boxes.push_back(_intervals[middle].boxID);
+        }
+      stab(middle + 1, last, date, boxes);
+    }
+}
+
+void
+TimelineIndex::boxesPlayingAt(unsigned int date, vector<unsigned int> &boxes)
+{
+  rebuildIntervals();
+  stab(0, _intervals.size(), date, boxes);
+}
+
+void
+TimelineIndex::boxesBegunBefore(unsigned int date, vector<unsigned int> &boxes)
+{
+  rebuildIntervals();
+  for (unsigned int i = 0; i < _intervals.size() && _intervals[i].begin < date; ++i) {
+      boxes.push_back(_intervals[i].boxID);
+    }
+}
+
+void
+TimelineIndex::boxesEndedBefore(unsigned int date, vector<unsigned int> &boxes)
+{
+  rebuildIntervals();
+  vector<pair<unsigned int, unsigned int> >::iterator last = std::lower_bound(_ends.begin(), _ends.end(), date, endDateBefore);
+  for (vector<pair<unsigned int, unsigned int> >::iterator it = _ends.begin(); it != last; ++it) {
+      boxes.push_back(it->second);
+    }
+}
+
+void
+TimelineIndex::stateAt(unsigned int date, QMap<AddressID, TimelineWrite> &state)
+{
+  if (_checkpointInterval != 0 && date > 0) {
+      // Checkpoints hold every write done at or before their date : the nearest one strictly before is used
+      unsigned int index = (date - 1) / _checkpointInterval;
+      buildCheckpoints(index);
+      state = _checkpoints[index];
+      replay(index * _checkpointInterval, date, state, true);
+      return;
+    }
+
+  for (QHash<AddressID, vector<TimelineWrite> >::const_iterator it = _writes.begin(); it != _writes.end(); ++it) {
+      const vector<TimelineWrite> &writes = it.value();
+      vector<TimelineWrite>::const_iterator writeIt = std::upper_bound(writes.begin(), writes.end(), date, writeDateAfter);
+
+      // The end of a box beginning at the date is not reached yet
+      while (writeIt != writes.begin()) {
+          --writeIt;
+          if (writeIt->end) {
+              map<unsigned int, BoxRecord>::const_iterator boxIt = _boxes.find(writeIt->boxID);
+              if (boxIt != _boxes.end() && boxIt->second.begin >= date) {
+                  continue;
+                }
+            }
+          state.insert(it.key(), *writeIt);
+          break;
+        }
+    }
+}
+
+void
+TimelineIndex::replay(unsigned int from, unsigned int to, QMap<AddressID, TimelineWrite> &state, bool skipUnreachedEnds) const
+{
+  ChronologyKey first;
+  first.date = from + 1;
+  first.boxID = std::numeric_limits<unsigned int>::max();
+  first.end = false;
+
+  TimelineWrite write;
+  for (map<ChronologyKey, QString>::const_iterator it = _chronology.lower_bound(first); it != _chronology.end() && it->first.date <= to; ++it) {
+      // The end of a box beginning at the last date is not reached yet
+      if (skipUnreachedEnds && it->first.end) {
+          map<unsigned int, BoxRecord>::const_iterator boxIt = _boxes.find(it->first.boxID);
+          if (boxIt != _boxes.end() && boxIt->second.begin >= to) {
+              continue;
+            }
+        }
+      write.date = it->first.date;
+      write.boxID = it->first.boxID;
+      write.end = it->first.end;
+      write.value = it->second;
+      state.insert(it->first.address, write);
+    }
+}
+
+void
+TimelineIndex::buildCheckpoints(unsigned int index)
+{
+  while (_checkpoints.size() <= index) {
+      unsigned int checkpoint = _checkpoints.size();
+      QMap<AddressID, TimelineWrite> state;
+      if (checkpoint > 0) {
+          state = _checkpoints.back();
+          replay((checkpoint - 1) * _checkpointInterval, checkpoint * _checkpointInterval, state, false);
+        }
+      else {
+          // Writes done at date 0
+          for (map<ChronologyKey, QString>::const_iterator it = _chronology.begin(); it != _chronology.end() && it->first.date == 0; ++it) {
+              TimelineWrite write;
+              write.date = 0;
+              write.boxID = it->first.boxID;
+              write.end = it->first.end;
+              write.value = it->second;
+              state.insert(it->first.address, write);
+            }
+        }
+
+      unsigned int memory = sizeof(state);
+      for (QMap<AddressID, TimelineWrite>::const_iterator it = state.begin(); it != state.end(); ++it) {
+          memory += sizeof(AddressID) + sizeof(TimelineWrite) + 2 * sizeof(void*)
+            + it.value().value.size() * sizeof(QChar);
+        }
+
+      _checkpoints.push_back(state);
+      _checkpointsMemory.push_back(memory);
+    }
+}
+
+void
+TimelineIndex::invalidateCheckpoints(unsigned int date)
+{
+  if (_checkpointInterval == 0) {
+      return;
+    }
+
+  // Checkpoints strictly before the date do not hold any write done at the date
+  unsigned int validCount = date / _checkpointInterval + (date % _checkpointInterval != 0 ? 1 : 0);
+  if (validCount < _checkpoints.size()) {
+      _checkpoints.resize(validCount);
+      _checkpointsMemory.resize(validCount);
+    }
+}
+
+void
+TimelineIndex::setCheckpointInterval(unsigned int interval)
+{
+  _checkpointInterval = interval;
+  _checkpoints.clear();
+  _checkpointsMemory.clear();
+}
+
+unsigned int
+TimelineIndex::checkpointsMemory() const
+{
+  unsigned int memory = 0;
+  for (vector<unsigned int>::const_iterator it = _checkpointsMemory.begin(); it != _checkpointsMemory.end(); ++it) {
+      memory += *it;
+    }
+  return memory;
+}
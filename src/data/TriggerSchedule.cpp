@@ -0,0 +1,129 @@
+/*
+ * Copyright: LaBRI / SCRIME
+ *
+ * This software is a computer program whose purpose is to provide
+ * notation/composition combining synthesized as well as recorded
+ * sounds, providing answers to the problem of notation and, drawing,
+ * from its very design, on benefits from state of the art research
+ * in musicology and sound/music computing.
+ *
+ * This software is governed by the CeCILL license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/*!
+ * \file TriggerSchedule.cpp
+ */
+
+#include "TriggerSchedule.hpp"
+
+#include <limits>
+
+using std::map;
+using std::multimap;
+using std::set;
+using std::pair;
+using std::vector;
+
+void
+TriggerSchedule::clear()
+{
+  _schedule.clear();
+  _triggers.clear();
+  _boxTriggers.clear();
+}
+
+void
+TriggerSchedule::setTrigger(unsigned int trgID, unsigned int boxID, unsigned int date)
+{
+  map<unsigned int, pair<unsigned int, unsigned int> >::iterator it = _triggers.find(trgID);
+  if (it != _triggers.end()) {
+      if (it->second.first == boxID && it->second.second == date) {
+          return;
+        }
+      removeTrigger(trgID);
+    }
+
+  _triggers[trgID] = pair<unsigned int, unsigned int>(boxID, date);
+  _schedule.insert(pair<unsigned int, unsigned int>(date, trgID));
+  _boxTriggers.insert(pair<unsigned int, unsigned int>(boxID, trgID));
+}
+
+void
+TriggerSchedule::removeTrigger(unsigned int trgID)
+{
+  map<unsigned int, pair<unsigned int, unsigned int> >::iterator it = _triggers.find(trgID);
+  if (it == _triggers.end()) {
+      return;
+    }
+
+  _schedule.erase(pair<unsigned int, unsigned int>(it->second.second, trgID));
+
+  pair<multimap<unsigned int, unsigned int>::iterator, multimap<unsigned int, unsigned int>::iterator> range = _boxTriggers.equal_range(it->second.first);
+  for (multimap<unsigned int, unsigned int>::iterator boxIt = range.first; boxIt != range.second; ++boxIt) {
+      if (boxIt->second == trgID) {
+          _boxTriggers.erase(boxIt);
+          break;
+        }
+    }
+
+  _triggers.erase(it);
+}
+
+bool
+TriggerSchedule::contains(unsigned int trgID) const
+{
+  return _triggers.find(trgID) != _triggers.end();
+}
+
+unsigned int
+TriggerSchedule::date(unsigned int trgID) const
+{
+  map<unsigned int, pair<unsigned int, unsigned int> >::const_iterator it = _triggers.find(trgID);
+  if (it != _triggers.end()) {
+      return it->second.second;
+    }
+  return 0;
+}
+
+void
+TriggerSchedule::boxTriggers(unsigned int boxID, vector<unsigned int> &triggers) const
+{
+  pair<multimap<unsigned int, unsigned int>::const_iterator, multimap<unsigned int, unsigned int>::const_iterator> range = _boxTriggers.equal_range(boxID);
+  for (multimap<unsigned int, unsigned int>::const_iterator it = range.first; it != range.second; ++it) {
+      triggers.push_back(it->second);
+    }
+}
+
+void
+TriggerSchedule::triggersAfter(unsigned int date, vector<unsigned int> &triggers) const
+{
+  set<pair<unsigned int, unsigned int> >::const_iterator it =
+    _schedule.upper_bound(pair<unsigned int, unsigned int>(date, std::numeric_limits<unsigned int>::max()));
+  for (; it != _schedule.end(); ++it) {
+      triggers.push_back(it->second);
+    }
+}